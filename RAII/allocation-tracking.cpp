@@ -0,0 +1,548 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    This is an extension of the file "memory-management.cpp" that
+    records how much memory the buffers hold. For every instantiation
+    of Buffer<T> (and for the global operator new/delete, i.e. all
+    heap memory of the program) it counts
+        - the number of allocations and deallocations
+        - the bytes that are currently allocated (live bytes)
+        - the largest number of live bytes seen so far (peak)
+        - a histogram of the allocation sizes (powers of two)
+
+    The counters are kept per thread, so counting costs a few plain
+    additions on memory that no other thread writes to. They are only
+    summed up when a report is requested. Only the live bytes are
+    forwarded to a shared counter from time to time (every 256 KiB),
+    which is needed to follow the peak. In between, a thread raises
+    the shared peak whenever its own not yet forwarded bytes reach a
+    new maximum, so the peak is never below a live value reached by
+    the allocations of a single thread. It may only miss up to 256 KiB
+    per other thread that allocated at the same time.
+
+    The tracking is compiled in only if TRACK_ALLOCATIONS is defined:
+        g++ -std=c++17 -O2 -DTRACK_ALLOCATIONS allocation-tracking.cpp -pthread
+    Otherwise all hooks are empty inline functions and the global
+    operator new/delete are not replaced, so there is no overhead at
+    all. A report can be printed at exit and whenever the process
+    receives a signal, e.g. "kill -USR1 <pid>".
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <typeinfo>
+
+#include <csignal>
+#include <pthread.h>
+#include <malloc.h>
+#include <cxxabi.h>
+
+// ############ Tracking layer ##############
+namespace tracking {
+#ifdef TRACK_ALLOCATIONS
+    constexpr std::size_t max_sites = 32;
+    constexpr std::size_t buckets = 65;
+    constexpr std::int64_t flush_bytes = 256 * 1024;
+
+    // site 0 is the global operator new, all other sites
+    // are registered by the Buffer instantiations
+    constexpr std::size_t global_site = 0;
+
+    // counters that are written by one thread and read by the
+    // report; relaxed atomics make this well defined without
+    // the cost of a locked instruction
+    struct Counter {
+        std::atomic<std::uint64_t> value{0};
+
+        void add(std::uint64_t x) {
+            value.store(value.load(std::memory_order_relaxed) + x,
+                std::memory_order_relaxed);
+        }
+
+        std::uint64_t get() const {
+            return value.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct SiteCounters {
+        Counter allocs;
+        Counter frees;
+        Counter bytes_allocated;
+        Counter bytes_freed;
+        Counter histogram[buckets];
+        // live bytes not yet forwarded to the shared counter
+        std::int64_t pending = 0;
+        // largest value of pending since the last forwarding
+        std::int64_t high = 0;
+    };
+
+    // shared state of a site
+    struct Site {
+        const char* name = nullptr;
+        std::atomic<std::int64_t> live{0};
+        std::atomic<std::int64_t> peak{0};
+        // counters of threads that have terminated
+        std::atomic<std::uint64_t> allocs{0};
+        std::atomic<std::uint64_t> frees{0};
+        std::atomic<std::uint64_t> bytes_allocated{0};
+        std::atomic<std::uint64_t> bytes_freed{0};
+        std::atomic<std::uint64_t> histogram[buckets] = {};
+    };
+
+    struct ThreadCounters;
+
+    // all global state is constant initialized and never destroyed,
+    // as it may be used by operator new before main and after exit
+    struct Registry {
+        std::mutex mutex;
+        Site sites[max_sites];
+        std::size_t num_sites = 1;
+        ThreadCounters* threads = nullptr;
+    };
+
+    inline Registry& registry() {
+        static Registry* r = new (std::malloc(sizeof(Registry))) Registry();
+        return *r;
+    }
+
+    inline void raise_peak(Site& s, std::int64_t now) {
+        std::int64_t peak = s.peak.load(std::memory_order_relaxed);
+        while (now > peak && !s.peak.compare_exchange_weak(peak, now,
+            std::memory_order_relaxed)) {
+        }
+    }
+
+    inline void update_peak(Site& s, std::int64_t delta) {
+        raise_peak(s, s.live.fetch_add(delta, std::memory_order_relaxed)
+            + delta);
+    }
+
+    // counters of one thread, linked into the registry for reports
+    struct ThreadCounters {
+        SiteCounters sites[max_sites];
+        ThreadCounters* next = nullptr;
+
+        ThreadCounters() {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            next = r.threads;
+            r.threads = this;
+        }
+
+        // hands the counters over to the sites on thread exit
+        ~ThreadCounters();
+    };
+
+    // true after the counters of this thread were destroyed
+    inline thread_local bool thread_done = false;
+
+    inline ThreadCounters* thread_counters() {
+        if (thread_done) {
+            return nullptr;
+        }
+        thread_local ThreadCounters tc;
+        return &tc;
+    }
+
+    inline std::size_t bucket(std::size_t bytes) {
+        std::size_t b = 0;
+        while (bytes > (std::size_t(1) << b) && b < buckets-1) {
+            ++b;
+        }
+        return b;
+    }
+
+    inline void record(std::size_t site, std::size_t bytes, bool allocation) {
+        Site& s = registry().sites[site];
+        ThreadCounters* tc = thread_counters();
+        if (tc == nullptr) {
+            // thread teardown: count directly in the site
+            if (allocation) {
+                s.allocs.fetch_add(1, std::memory_order_relaxed);
+                s.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+                s.histogram[bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+            } else {
+                s.frees.fetch_add(1, std::memory_order_relaxed);
+                s.bytes_freed.fetch_add(bytes, std::memory_order_relaxed);
+            }
+            update_peak(s, allocation ? bytes : -std::int64_t(bytes));
+            return;
+        }
+        SiteCounters& c = tc->sites[site];
+        if (allocation) {
+            c.allocs.add(1);
+            c.bytes_allocated.add(bytes);
+            c.histogram[bucket(bytes)].add(1);
+            c.pending += bytes;
+            // only the first time a level is reached, so a loop that
+            // allocates and frees the same sizes does this only once
+            if (c.pending > c.high) {
+                c.high = c.pending;
+                raise_peak(s, s.live.load(std::memory_order_relaxed) + c.pending);
+            }
+        } else {
+            c.frees.add(1);
+            c.bytes_freed.add(bytes);
+            c.pending -= bytes;
+        }
+        if (c.pending >= flush_bytes || c.pending <= -flush_bytes) {
+            update_peak(s, c.pending);
+            c.pending = 0;
+            c.high = 0;
+        }
+    }
+
+    inline ThreadCounters::~ThreadCounters() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (std::size_t i=0; i<max_sites; ++i) {
+            Site& s = r.sites[i];
+            SiteCounters& c = sites[i];
+            s.allocs.fetch_add(c.allocs.get(), std::memory_order_relaxed);
+            s.frees.fetch_add(c.frees.get(), std::memory_order_relaxed);
+            s.bytes_allocated.fetch_add(c.bytes_allocated.get(),
+                std::memory_order_relaxed);
+            s.bytes_freed.fetch_add(c.bytes_freed.get(),
+                std::memory_order_relaxed);
+            for (std::size_t b=0; b<buckets; ++b) {
+                s.histogram[b].fetch_add(c.histogram[b].get(),
+                    std::memory_order_relaxed);
+            }
+            update_peak(s, c.pending);
+        }
+        ThreadCounters** p = &r.threads;
+        while (*p != this) {
+            p = &(*p)->next;
+        }
+        *p = next;
+        thread_done = true;
+    }
+
+    inline std::size_t register_site(const char* name) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (r.num_sites == max_sites) {
+            // out of sites, count in the last one
+            return max_sites - 1;
+        }
+        r.sites[r.num_sites].name = name;
+        return r.num_sites++;
+    }
+
+    // one site per element type
+    template <typename T>
+    std::size_t site() {
+        static const std::size_t id = register_site(
+            abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, nullptr));
+        return id;
+    }
+
+    // hooks called by Buffer
+    template <typename T>
+    inline void on_allocate(std::size_t bytes) {
+        record(site<T>(), bytes, true);
+    }
+
+    template <typename T>
+    inline void on_deallocate(std::size_t bytes) {
+        record(site<T>(), bytes, false);
+    }
+
+    // sums up the counters of all threads and prints them
+    inline void report(std::ostream& out) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        out << "---- allocation report (peak resolution: "
+            << flush_bytes / 1024 << " KiB per concurrent thread) ----" << std::endl;
+        for (std::size_t i=0; i<r.num_sites; ++i) {
+            Site& s = r.sites[i];
+            std::uint64_t allocs = s.allocs.load(std::memory_order_relaxed);
+            std::uint64_t frees = s.frees.load(std::memory_order_relaxed);
+            std::uint64_t in = s.bytes_allocated.load(std::memory_order_relaxed);
+            std::uint64_t outb = s.bytes_freed.load(std::memory_order_relaxed);
+            std::uint64_t hist[buckets];
+            for (std::size_t b=0; b<buckets; ++b) {
+                hist[b] = s.histogram[b].load(std::memory_order_relaxed);
+            }
+            for (ThreadCounters* t=r.threads; t!=nullptr; t=t->next) {
+                SiteCounters& c = t->sites[i];
+                allocs += c.allocs.get();
+                frees += c.frees.get();
+                in += c.bytes_allocated.get();
+                outb += c.bytes_freed.get();
+                for (std::size_t b=0; b<buckets; ++b) {
+                    hist[b] += c.histogram[b].get();
+                }
+            }
+            std::int64_t live = static_cast<std::int64_t>(in - outb);
+            std::int64_t peak = s.peak.load(std::memory_order_relaxed);
+            out << (i == global_site ? "operator new (all)" : s.name) << ":"
+                << std::endl
+                << "    allocations: " << allocs << ", deallocations: " << frees
+                << std::endl
+                << "    live bytes: " << live << ", peak bytes: "
+                << (live > peak ? live : peak) << std::endl
+                << "    sizes:";
+            for (std::size_t b=0; b<buckets; ++b) {
+                if (hist[b] > 0) {
+                    out << " <=" << (std::uint64_t(1) << b) << ": " << hist[b];
+                }
+            }
+            out << std::endl;
+        }
+    }
+#else
+    // tracking compiled out: the hooks do nothing
+    template <typename T>
+    inline void on_allocate(std::size_t) {
+    }
+
+    template <typename T>
+    inline void on_deallocate(std::size_t) {
+    }
+
+    inline void report(std::ostream& out) {
+        out << "allocation tracking is disabled, "
+            "compile with -DTRACK_ALLOCATIONS" << std::endl;
+    }
+#endif
+
+    // prints the report to stderr when the program ends
+    inline void report_at_exit() {
+        std::atexit([]() {
+            report(std::cerr);
+        });
+    }
+
+    // prints the report to stderr whenever the process receives
+    // signal sig. The signal is blocked in the calling thread and
+    // all threads it creates afterwards (so call it early in main)
+    // and picked up by a background thread with sigwait; this way
+    // the report is not printed from within a signal handler.
+    inline void report_on_signal(int sig) {
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, sig);
+        pthread_sigmask(SIG_BLOCK, &set, nullptr);
+        std::thread([set]() {
+            int received;
+            while (sigwait(&set, &received) == 0) {
+                report(std::cerr);
+            }
+        }).detach();
+    }
+}
+
+#ifdef TRACK_ALLOCATIONS
+// ############ Replacement of the global operator new/delete ##############
+// the sizes are taken from malloc_usable_size, so that allocation
+// and deallocation agree even if delete is called without size;
+// the operators are kept out of line, like in a library
+__attribute__((noinline))
+void* operator new(std::size_t bytes) {
+    void* p = std::malloc(bytes > 0 ? bytes : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    tracking::record(tracking::global_site, malloc_usable_size(p), true);
+    return p;
+}
+
+__attribute__((noinline))
+void* operator new(std::size_t bytes, std::align_val_t al) {
+    std::size_t a = static_cast<std::size_t>(al);
+    void* p = std::aligned_alloc(a, (bytes + a - 1) / a * a);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    tracking::record(tracking::global_site, malloc_usable_size(p), true);
+    return p;
+}
+
+__attribute__((noinline))
+void operator delete(void* p) noexcept {
+    if (p != nullptr) {
+        tracking::record(tracking::global_site, malloc_usable_size(p), false);
+        std::free(p);
+    }
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    operator delete(p);
+}
+#endif
+
+// ############ Buffer class ##############
+// same as in memory-management.cpp with hooks in the allocation path
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            T* p = static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+            tracking::on_allocate<T>(n*sizeof(T));
+            return p;
+        }
+
+        static void release(T* p, std::size_t n) {
+            if (p != nullptr) {
+                tracking::on_deallocate<T>(n*sizeof(T));
+            }
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_, size_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_, size_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_, size_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        size_t size() {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+template <typename T, std::size_t A>
+void init_buffer(Buffer<T, A>& b) {
+    for (size_t i=0; i<b.size(); ++i) {
+        b[i] = i+1;
+    }
+}
+
+
+int main() {
+    tracking::report_on_signal(SIGUSR1);
+    tracking::report_at_exit();
+
+    // some threads that allocate buffers of different types
+    std::vector<std::thread> workers;
+    for (int t=0; t<4; ++t) {
+        workers.emplace_back([t]() {
+            for (int i=0; i<1000; ++i) {
+                Buffer<double> d(16 << (i % 8));
+                Buffer<int> n(100 + t);
+                init_buffer(d);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // these stay alive until the end and show up as live bytes
+    Buffer<float, 64> f(1 << 20);
+    Buffer<char> c(4000);
+
+    // report on request, as if sent by "kill -USR1 <pid>"
+    kill(getpid(), SIGUSR1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // overhead of the hooks (compare builds with and without tracking)
+    auto start = std::chrono::steady_clock::now();
+    for (int i=0; i<1000000; ++i) {
+        Buffer<long> b(64, uninitialized);
+        b[0] = i;
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    std::cout << "Buffer construction + destruction: " << dt.count() * 1e3
+        << " ns" << std::endl;
+} // the final report is printed after f and c are released
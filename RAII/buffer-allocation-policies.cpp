@@ -0,0 +1,432 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    This is an extension of the file "buffer-pool.cpp" for very large
+    buffers (hundreds of MB up to GBs) on Linux. It provides allocator
+    policies that control how the memory of a Buffer is mapped:
+        - HeapAllocator: plain operator new/delete
+        - TransparentHugePages: anonymous mmap, aligned to 2 MiB and
+          marked with madvise(MADV_HUGEPAGE)
+        - ExplicitHugePages: mmap with MAP_HUGETLB from the reserved
+          huge page pool (/proc/sys/vm/nr_hugepages); falls back to
+          TransparentHugePages if the pool is empty
+        - NumaInterleave: pages are distributed round robin over all
+          NUMA nodes (mbind with MPOL_INTERLEAVE)
+        - NumaFirstTouch: every page is placed on the node of the
+          thread that touches it first (the kernel default)
+
+    Huge pages reduce the number of TLB misses, as one TLB entry
+    covers 2 MiB instead of 4 KiB. On machines with several sockets
+    the placement of pages matters as well: if a single thread
+    initializes the whole buffer, all pages end up on its node and
+    all other sockets have to go through the interconnect.
+    init_buffer_parallel therefore touches the buffer from several
+    pinned threads using the same static partitioning (for_each_chunk)
+    that later compute loops should use, so each thread finds its
+    part of the buffer in local memory.
+
+    Note that Buffer(n) value initializes all elements from the
+    calling thread, which already is a (serial) first touch. Use
+    Buffer(n, uninitialized) followed by init_buffer_parallel instead.
+    Pages of anonymous mappings are zero anyway.
+
+    NUMA placement is done with the raw mbind syscall, so libnuma is
+    not needed. If the kernel does not support it (or there is only
+    one node) the call fails and the memory is used as is.
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <linux/mempolicy.h>
+
+// tag type to select the constructor that leaves the
+// elements uninitialized
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Helper functions for mappings ##############
+namespace mapping {
+    constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+    inline std::size_t round_up(std::size_t n, std::size_t m) {
+        return (n + m - 1) / m * m;
+    }
+
+    // all mappings below cover whole huge pages, so the last
+    // (partial) huge page can be backed by a huge page as well
+    inline std::size_t length(std::size_t bytes) {
+        return round_up(bytes > 0 ? bytes : 1, huge_page_size);
+    }
+
+    // anonymous mapping that starts at a 2 MiB boundary; as mmap
+    // only guarantees 4 KiB alignment, we map one huge page more
+    // than needed and cut off the unaligned head and the tail
+    inline void* map_aligned(std::size_t bytes) {
+        std::size_t len = length(bytes);
+        void* raw = mmap(nullptr, len + huge_page_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        auto addr = reinterpret_cast<std::uintptr_t>(raw);
+        auto aligned = round_up(addr, huge_page_size);
+        if (aligned > addr) {
+            munmap(raw, aligned - addr);
+        }
+        std::size_t tail = addr + len + huge_page_size - (aligned + len);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(aligned + len), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    inline void unmap(void* p, std::size_t bytes) {
+        if (p != nullptr) {
+            munmap(p, length(bytes));
+        }
+    }
+
+    // bit mask of all NUMA nodes known to the kernel
+    inline unsigned long node_mask() {
+        unsigned long mask = 0;
+        for (unsigned node=0; node<8*sizeof(mask); ++node) {
+            std::string path = "/sys/devices/system/node/node"
+                + std::to_string(node);
+            if (access(path.c_str(), F_OK) == 0) {
+                mask |= 1ul << node;
+            }
+        }
+        return mask;
+    }
+
+    // node of the page that contains p, -1 if the page has
+    // not been touched yet, < -1 on error
+    inline int node_of(void* p) {
+        void* page = reinterpret_cast<void*>(
+            reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(4095));
+        int status = -1;
+        if (syscall(SYS_move_pages, 0, 1ul, &page, nullptr, &status, 0) != 0) {
+            return -2;
+        }
+        return status < 0 ? -1 : status;
+    }
+}
+
+// ############ Allocator policies ##############
+// an allocator policy is a class with two static methods
+//     void* allocate(std::size_t bytes, std::size_t alignment)
+//     void deallocate(void* p, std::size_t bytes, std::size_t alignment)
+// and the constant page_size, the size of the pages backing the
+// memory; the policies based on mmap always align to 2 MiB
+
+struct HeapAllocator {
+    static constexpr std::size_t page_size = 4096;
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    static void deallocate(void* p, std::size_t, std::size_t alignment) {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+};
+
+struct TransparentHugePages {
+    static constexpr std::size_t page_size = mapping::huge_page_size;
+
+    static void* allocate(std::size_t bytes, std::size_t) {
+        void* p = mapping::map_aligned(bytes);
+        // only a hint; it has no effect if THP are disabled
+        madvise(p, mapping::length(bytes), MADV_HUGEPAGE);
+        return p;
+    }
+
+    static void deallocate(void* p, std::size_t bytes, std::size_t) {
+        mapping::unmap(p, bytes);
+    }
+};
+
+struct ExplicitHugePages {
+    static constexpr std::size_t page_size = mapping::huge_page_size;
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        void* p = mmap(nullptr, mapping::length(bytes), PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED) {
+            // no (or not enough) huge pages reserved
+            return TransparentHugePages::allocate(bytes, alignment);
+        }
+        return p;
+    }
+
+    // both kinds of mappings have the same length
+    static void deallocate(void* p, std::size_t bytes, std::size_t) {
+        mapping::unmap(p, bytes);
+    }
+};
+
+// interleaving happens per huge page
+struct NumaInterleave {
+    static constexpr std::size_t page_size = mapping::huge_page_size;
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        void* p = TransparentHugePages::allocate(bytes, alignment);
+        // the policy has to be set before the first touch;
+        // failure is not an error, the pages are placed by
+        // first touch then
+        unsigned long mask = mapping::node_mask();
+        syscall(SYS_mbind, p, mapping::length(bytes), MPOL_INTERLEAVE,
+            &mask, 8*sizeof(mask), 0);
+        return p;
+    }
+
+    static void deallocate(void* p, std::size_t bytes, std::size_t) {
+        mapping::unmap(p, bytes);
+    }
+};
+
+// nothing to do on allocation, the placement happens
+// in init_buffer_parallel
+struct NumaFirstTouch : TransparentHugePages {
+};
+
+// ############ Buffer class ##############
+// same as in buffer-pool.cpp
+template <typename T,
+    std::size_t Alignment = alignof(T),
+    typename Allocator = HeapAllocator>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(Allocator::allocate(n*sizeof(T), Alignment));
+        }
+
+        static void release(T* p, std::size_t n) {
+            Allocator::deallocate(p, n*sizeof(T), Alignment);
+        }
+
+    public:
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_, size_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_, size_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_, size_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        size_t size() {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// ############ Parallel first touch ##############
+// splits [0, n) into one contiguous chunk per thread and calls
+// f(thread, begin, end) on thread number 'thread', which pins
+// itself to cpu 'thread' (modulo the number of cpus) before calling
+// f, so the first touch happens on the right node. The chunk size is
+// a multiple of the page size of the allocator policy (2 MiB for the
+// huge page policies), so with page aligned data no page is shared
+// by two threads; otherwise one thread would place the neighbouring
+// parts of its huge page for the other threads as well.
+// Compute loops that use the same function and the same number of
+// threads access the same elements as during initialization.
+template <typename T, typename Allocator, typename Func>
+void for_each_chunk(std::size_t n, std::size_t threads, Func f) {
+    const std::size_t page_elems = Allocator::page_size / sizeof(T) > 0 ?
+        Allocator::page_size / sizeof(T) : 1;
+    const std::size_t chunk = mapping::round_up((n + threads - 1) / threads,
+        page_elems);
+    const unsigned cpus = std::thread::hardware_concurrency() > 0 ?
+        std::thread::hardware_concurrency() : 1;
+
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t<threads; ++t) {
+        std::size_t begin = t*chunk < n ? t*chunk : n;
+        std::size_t end = begin + chunk < n ? begin + chunk : n;
+        workers.emplace_back([&f, t, begin, end, cpus]() {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(t % cpus, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            f(t, begin, end);
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+// serial version from memory-management.cpp
+template <typename T, std::size_t A, typename Alloc>
+void init_buffer(Buffer<T, A, Alloc>& b) {
+    for (size_t i=0; i<b.size(); ++i) {
+        b[i] = i+1;
+    }
+}
+
+// parallel version, places every page next to the thread
+// that will work on it
+template <typename T, std::size_t A, typename Alloc>
+void init_buffer_parallel(Buffer<T, A, Alloc>& b, std::size_t threads) {
+    T* d = b.data();
+    for_each_chunk<T, Alloc>(b.size(), threads,
+        [d](std::size_t, std::size_t begin, std::size_t end) {
+            for (std::size_t i=begin; i<end; ++i) {
+                d[i] = i+1;
+            }
+        });
+}
+
+// ############ Benchmark ##############
+// random reads over the whole buffer hit a different page almost
+// every time, so this loop is dominated by TLB misses
+template <typename T, std::size_t A, typename Alloc>
+double random_reads(Buffer<T, A, Alloc>& b, std::size_t reads, std::size_t threads) {
+    std::vector<double> partial(threads);
+    T* d = b.data();
+    const std::size_t n = b.size();
+    auto start = std::chrono::steady_clock::now();
+    for_each_chunk<T, Alloc>(n, threads,
+        [&partial, d, n, reads, threads](std::size_t t, std::size_t, std::size_t) {
+            std::uint64_t x = 88172645463325252ull + t;
+            double sum = 0.0;
+            for (std::size_t r=0; r<reads/threads; ++r) {
+                // xorshift random number generator
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                sum += d[x % n];
+            }
+            partial[t] = sum;
+        });
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    volatile double sink = 0.0;
+    for (double p : partial) {
+        sink = sink + p;
+    }
+    return dt.count() * 1e9 / reads;
+}
+
+template <typename Alloc>
+void run(const char* name, std::size_t n, std::size_t threads) {
+    auto start = std::chrono::steady_clock::now();
+    Buffer<double, 64, Alloc> b(n, uninitialized);
+    init_buffer_parallel(b, threads);
+    std::chrono::duration<double> init = std::chrono::steady_clock::now() - start;
+    double ns = random_reads(b, 20000000, threads);
+    std::cout << "    " << name << ": init " << init.count() << " s, "
+        << ns << " ns per random read, first page on node "
+        << mapping::node_of(b.data()) << ", last page on node "
+        << mapping::node_of(b.data() + n - 1) << std::endl;
+}
+
+
+int main() {
+    const std::size_t n = (std::size_t(512) << 20) / sizeof(double);
+    const std::size_t threads = std::thread::hardware_concurrency() > 0 ?
+        std::thread::hardware_concurrency() : 1;
+    std::cout << "512 MiB of doubles, " << threads << " thread(s):" << std::endl;
+
+    run<HeapAllocator>("HeapAllocator", n, threads);
+    run<TransparentHugePages>("TransparentHugePages", n, threads);
+    run<ExplicitHugePages>("ExplicitHugePages", n, threads);
+    run<NumaInterleave>("NumaInterleave", n, threads);
+    run<NumaFirstTouch>("NumaFirstTouch", n, threads);
+
+    // the serial initialization places all pages
+    // on the node of the main thread
+    Buffer<double, 64, NumaFirstTouch> serial(n, uninitialized);
+    init_buffer(serial);
+    std::cout << "serial init: first page on node "
+        << mapping::node_of(serial.data()) << ", last page on node "
+        << mapping::node_of(serial.data() + n - 1) << std::endl;
+}
@@ -0,0 +1,295 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    Since the Buffer of "memory-management.cpp" provides begin() and
+    end(), the parallel overloads of the standard algorithms (c++17)
+    can be used on it. The first argument of these overloads is an
+    execution policy:
+        - std::execution::seq: serial, like the classic algorithms
+        - std::execution::par: the work is split across threads
+        - std::execution::par_unseq: split across threads and each
+          thread may additionally vectorize its part
+    This file wraps fill, transform and reduce into small helper
+    functions that use par_unseq for large buffers and stay serial
+    for small ones, where starting the threads costs more than the
+    work itself. The main function compares them with the
+    hand-written loop of init_buffer.
+
+    With gcc the parallel algorithms are implemented on top of
+    Intel TBB, so the program has to be linked against it:
+        g++ -std=c++20 -O2 buffer-parallel-algorithms.cpp -ltbb
+    Without the TBB headers, the policies silently run serially.
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <span>
+#include <algorithm>
+#include <numeric>
+#include <execution>
+#include <functional>
+#include <chrono>
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+constexpr std::size_t cacheline_alignment = 64;
+
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Buffer class from memory-management.cpp ##############
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// serial version from memory-management.cpp
+template <typename T, std::size_t A>
+void init_buffer(Buffer<T, A>& b) {
+    for (size_t i=0; i<b.size(); ++i) {
+        b[i] = i+1;
+    }
+}
+
+// ############ Parallel helper functions ##############
+// below this number of elements the helpers run serially
+constexpr std::size_t parallel_threshold = std::size_t(1) << 15;
+
+// sets all elements to value
+template <typename T, std::size_t A>
+void parallel_fill(Buffer<T, A>& b, const T& value) {
+    if (b.size() < parallel_threshold) {
+        std::fill(b.begin(), b.end(), value);
+    } else {
+        std::fill(std::execution::par_unseq, b.begin(), b.end(), value);
+    }
+}
+
+// out[i] = f(in[i]); in and out may be the same buffer
+template <typename T, std::size_t A, typename U, std::size_t B, typename Func>
+void parallel_transform(const Buffer<T, A>& in, Buffer<U, B>& out, Func f) {
+    std::size_t n = std::min(in.size(), out.size());
+    if (n < parallel_threshold) {
+        std::transform(in.begin(), in.begin() + n, out.begin(), f);
+    } else {
+        std::transform(std::execution::par_unseq,
+            in.begin(), in.begin() + n, out.begin(), f);
+    }
+}
+
+// combines all elements with op, which has to be associative and
+// commutative, as the order of evaluation is not specified
+template <typename T, std::size_t A, typename R, typename Op = std::plus<>>
+R parallel_reduce(const Buffer<T, A>& b, R init, Op op = Op()) {
+    if (b.size() < parallel_threshold) {
+        return std::reduce(b.begin(), b.end(), init, op);
+    }
+    return std::reduce(std::execution::par_unseq, b.begin(), b.end(), init, op);
+}
+
+// parallel version of init_buffer; the index of an element
+// follows from its address
+template <typename T, std::size_t A>
+void parallel_init_buffer(Buffer<T, A>& b) {
+    T* first = b.data();
+    auto f = [first](T& x) {
+        x = static_cast<T>(&x - first + 1);
+    };
+    if (b.size() < parallel_threshold) {
+        std::for_each(b.begin(), b.end(), f);
+    } else {
+        std::for_each(std::execution::par_unseq, b.begin(), b.end(), f);
+    }
+}
+
+// ############ Benchmark ##############
+template <typename Func>
+double measure(Func f, std::size_t repetitions) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r=0; r<repetitions; ++r) {
+        f();
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    return dt.count() * 1e3 / repetitions;
+}
+
+
+int main() {
+    for (std::size_t n : {std::size_t(1) << 10, std::size_t(1) << 20,
+            std::size_t(1) << 26}) {
+        std::size_t rep = n < (std::size_t(1) << 20) ? 10000 : 10;
+        Buffer<double, cacheline_alignment> a(n, uninitialized);
+        Buffer<double, cacheline_alignment> b(n, uninitialized);
+        std::cout << n << " doubles (ms per call):" << std::endl;
+
+        double ts = measure([&]() { init_buffer(a); }, rep);
+        double tp = measure([&]() { parallel_init_buffer(a); }, rep);
+        std::cout << "    init:      serial " << ts << ", parallel " << tp
+            << std::endl;
+
+        ts = measure([&]() {
+            for (std::size_t i=0; i<n; ++i) {
+                b[i] = 2.0 * a[i] + 1.0;
+            }
+        }, rep);
+        tp = measure([&]() {
+            parallel_transform(a, b, [](double x) { return 2.0 * x + 1.0; });
+        }, rep);
+        std::cout << "    transform: serial " << ts << ", parallel " << tp
+            << std::endl;
+
+        double s1 = 0.0;
+        double s2 = 0.0;
+        ts = measure([&]() {
+            s1 = 0.0;
+            for (std::size_t i=0; i<n; ++i) {
+                s1 += b[i];
+            }
+        }, rep);
+        tp = measure([&]() { s2 = parallel_reduce(b, 0.0); }, rep);
+        std::cout << "    reduce:    serial " << ts << ", parallel " << tp
+            << " (sums " << s1 << " and " << s2 << ")" << std::endl;
+
+        parallel_fill(a, 0.0);
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
@@ -0,0 +1,335 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    This is an extension of the file "memory-management.cpp", which
+    adds an allocator policy to the Buffer class and a pool that
+    recycles the memory of destroyed buffers.
+
+    Every construction of a Buffer calls operator new and every
+    destruction calls operator delete. When the same few sizes are
+    requested over and over again (e.g. one buffer per request in a
+    server loop) it is cheaper to keep released blocks around and
+    hand them out again on the next request.
+
+    The pool rounds every request up to a power of two (size class)
+    and keeps one free list per size class. The free lists are
+    thread_local, hence no thread ever has to wait for another one.
+    A block released by a different thread than the one that
+    allocated it simply ends up in the free list of the releasing
+    thread. Requests above the largest size class go directly to
+    operator new. Each list holds a limited number of blocks; the
+    remaining blocks and the lists themselves are released when the
+    thread terminates.
+
+    The Buffer releases its memory through the allocator policy in
+    its destructor, so the pool is completely hidden behind RAII.
+    The main function compares the pool against plain new/delete.
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+constexpr std::size_t cacheline_alignment = 64;
+
+// tag type to select the constructor that leaves the
+// elements uninitialized
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Allocator policies ##############
+// an allocator policy is a class with two static methods
+//     void* allocate(std::size_t bytes, std::size_t alignment)
+//     void deallocate(void* p, std::size_t bytes, std::size_t alignment)
+
+// default policy: plain aligned operator new/delete
+struct HeapAllocator {
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    static void deallocate(void* p, std::size_t, std::size_t alignment) {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+};
+
+// pool with power-of-two size classes from 64 bytes up to 4 MiB
+class BufferPool {
+    public:
+        static constexpr std::size_t min_block = 64;
+        static constexpr std::size_t num_classes = 17;
+        static constexpr std::size_t max_block = min_block << (num_classes-1);
+        // every block is aligned to a cache line, larger alignments
+        // are passed on to operator new
+        static constexpr std::size_t block_alignment = cacheline_alignment;
+        // number of blocks a thread keeps per size class
+        static constexpr std::size_t max_cached = 32;
+
+    private:
+        // released blocks are chained through their first bytes
+        struct Node {
+            Node* next;
+        };
+
+        struct FreeList {
+            Node* head = nullptr;
+            std::size_t count = 0;
+        };
+
+        // one instance per thread, its destructor hands all
+        // cached blocks back to the system on thread exit
+        struct ThreadCache {
+            FreeList lists[num_classes];
+            std::size_t hits = 0;
+            std::size_t misses = 0;
+
+            ~ThreadCache() {
+                for (std::size_t c=0; c<num_classes; ++c) {
+                    while (lists[c].head) {
+                        Node* n = lists[c].head;
+                        lists[c].head = n->next;
+                        ::operator delete(n, std::align_val_t(block_alignment));
+                    }
+                }
+            }
+        };
+
+        static ThreadCache& cache() {
+            thread_local ThreadCache tc;
+            return tc;
+        }
+
+        // index of the smallest class that holds 'bytes'
+        static std::size_t size_class(std::size_t bytes) {
+            std::size_t c = 0;
+            std::size_t block = min_block;
+            while (block < bytes) {
+                block <<= 1;
+                ++c;
+            }
+            return c;
+        }
+
+        static bool pooled(std::size_t bytes, std::size_t alignment) {
+            return bytes <= max_block && alignment <= block_alignment;
+        }
+
+    public:
+        static void* allocate(std::size_t bytes, std::size_t alignment) {
+            if (!pooled(bytes, alignment)) {
+                return ::operator new(bytes, std::align_val_t(alignment));
+            }
+            std::size_t c = size_class(bytes);
+            ThreadCache& tc = cache();
+            FreeList& fl = tc.lists[c];
+            if (fl.head) {
+                Node* n = fl.head;
+                fl.head = n->next;
+                --fl.count;
+                ++tc.hits;
+                return n;
+            }
+            ++tc.misses;
+            return ::operator new(min_block << c,
+                std::align_val_t(block_alignment));
+        }
+
+        static void deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+            if (p == nullptr) {
+                return;
+            }
+            if (!pooled(bytes, alignment)) {
+                ::operator delete(p, std::align_val_t(alignment));
+                return;
+            }
+            FreeList& fl = cache().lists[size_class(bytes)];
+            if (fl.count == max_cached) {
+                ::operator delete(p, std::align_val_t(block_alignment));
+                return;
+            }
+            fl.head = ::new (p) Node{fl.head};
+            ++fl.count;
+        }
+
+        // statistics of the calling thread
+        static std::size_t hits() {
+            return cache().hits;
+        }
+
+        static std::size_t misses() {
+            return cache().misses;
+        }
+};
+
+// ############ Buffer class ##############
+// same as in memory-management.cpp, the only difference is that
+// memory is requested from and returned to the Allocator policy
+template <typename T,
+    std::size_t Alignment = alignof(T),
+    typename Allocator = HeapAllocator>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(Allocator::allocate(n*sizeof(T), Alignment));
+        }
+
+        static void release(T* p, std::size_t n) {
+            Allocator::deallocate(p, n*sizeof(T), Alignment);
+        }
+
+    public:
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_, size_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        // the destructor gives the memory back to the allocator,
+        // i.e. to the pool if one is used
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_, size_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_, size_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        size_t size() {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// ############ Benchmark ##############
+// simulates a request loop: every iteration creates and destroys
+// a few buffers of typical sizes and touches one element of each
+// so that the compiler cannot remove the allocation
+template <typename Allocator>
+double request_loop(std::size_t iterations) {
+    const std::size_t sizes[] = {16, 200, 1000, 4096, 70000};
+    double sum = 0.0;
+    for (std::size_t it=0; it<iterations; ++it) {
+        for (std::size_t s : sizes) {
+            Buffer<double, cacheline_alignment, Allocator> b(s, uninitialized);
+            b[0] = static_cast<double>(it);
+            sum += b[0];
+        }
+    }
+    return sum;
+}
+
+template <typename Allocator>
+double run(const char* name, std::size_t threads, std::size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t<threads; ++t) {
+        workers.emplace_back([iterations]() {
+            volatile double sink = request_loop<Allocator>(iterations);
+            (void)sink;
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    double ns = dt.count() * 1e9 / (threads * iterations * 5);
+    std::cout << "    " << name << ": " << ns << " ns per buffer" << std::endl;
+    return ns;
+}
+
+
+int main() {
+    {
+        // the first buffer has to be allocated...
+        Buffer<int, cacheline_alignment, BufferPool> a(100);
+    } // ... but its memory goes back to the pool here
+    {
+        // so that this buffer reuses it
+        Buffer<int, cacheline_alignment, BufferPool> b(120);
+    }
+    std::cout << "pool hits: " << BufferPool::hits()
+        << ", misses: " << BufferPool::misses() << std::endl;
+
+    const std::size_t iterations = 200000;
+    const std::size_t max_threads = std::thread::hardware_concurrency() > 1 ?
+        std::thread::hardware_concurrency() : 2;
+    for (std::size_t threads=1; threads<=max_threads; threads*=2) {
+        std::cout << threads << " thread(s):" << std::endl;
+        double heap = run<HeapAllocator>("new/delete", threads, iterations);
+        double pool = run<BufferPool>("BufferPool", threads, iterations);
+        std::cout << "    speedup: " << heap/pool << std::endl;
+    }
+}
@@ -0,0 +1,751 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    A compressed companion to the Buffer of "memory-management.cpp"
+    for integral types. Columns of integers often hold small values
+    or values that increase monotonically (ids, timestamps), so most
+    of their bits are zero. If a scan over such a column is limited
+    by memory bandwidth, reading fewer bytes directly makes it faster.
+
+    The values are split into blocks of 256. Each block is stored
+    with the smallest bit width b that can hold its largest value,
+    i.e. a block takes 256*b bits instead of 256*8*sizeof(T) bytes.
+    Optionally, differences of neighbouring values are stored instead
+    of the values themselves (delta encoding), which turns a sorted
+    column into a column of small numbers. Negative numbers (and
+    negative differences) are mapped to positive ones by the zigzag
+    encoding 0, -1, 1, -2, 2, ... -> 0, 1, 2, 3, 4, ...
+
+    The bits are laid out "vertically": the block is treated as
+    lanes of 32-bit words (8 lanes) or 64-bit words (4 lanes), one
+    lane per position in a 256-bit SIMD register. Value i goes to
+    lane i % lanes, and every lane is packed separately. Decoding
+    then performs the same shifts and masks on all lanes at once,
+    so one AVX2 instruction decodes 8 (or 4) values. Likewise, the
+    delta refers to the value one row (lanes positions) before,
+    such that undoing it is a single vector addition per row.
+    The AVX2 kernel is selected at runtime if the cpu supports it,
+    otherwise a portable loop (that compilers vectorize as well)
+    is used. There is one kernel per bit width, so all shifts are
+    compile time constants.
+
+    The iterator decodes one block at a time and can be used with
+    range-based for loops and the standard algorithms. The fastest
+    way to scan is for_each_block, which hands out whole decoded
+    blocks. How much is gained compared to a plain Buffer depends on
+    how much the scan is limited by memory bandwidth, e.g. when all
+    cores scan at the same time.
+
+    Like Number<T> in integral_template_parameter_specification_1.cpp
+    the class is restricted to integral types with a c++20 requires
+    clause.
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <span>
+#include <bit>
+#include <array>
+#include <algorithm>
+#include <chrono>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Buffer class from memory-management.cpp ##############
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// ############ Bit packing kernels ##############
+namespace bitpack {
+    constexpr std::size_t block_size = 256;
+
+    // W is the unsigned word type of the lanes
+    template <typename W>
+    constexpr std::size_t word_bits = 8*sizeof(W);
+
+    template <typename W>
+    constexpr std::size_t lanes = 256 / word_bits<W>;
+
+    // number of values per lane, equal to the number of bits of W
+    template <typename W>
+    constexpr std::size_t rows = block_size / lanes<W>;
+
+    template <typename W>
+    W zigzag(W x) {
+        using S = std::make_signed_t<W>;
+        return (x << 1) ^ static_cast<W>(static_cast<S>(x) >> (word_bits<W>-1));
+    }
+
+    template <typename W>
+    W unzigzag(W u) {
+        return (u >> 1) ^ (W(0) - (u & 1));
+    }
+
+    template <typename W>
+    W low_bits(unsigned bits) {
+        return bits >= word_bits<W> ? ~W(0) : (W(1) << bits) - 1;
+    }
+
+    // packs one block of values with 'bits' bits each into
+    // lanes*bits words (which have to be zero initially); with
+    // bits == 0 there are no words and nothing to do
+    template <typename W>
+    void pack(const W* in, W* out, unsigned bits) {
+        constexpr std::size_t L = lanes<W>;
+        constexpr std::size_t WB = word_bits<W>;
+        if (bits == 0) {
+            return;
+        }
+        for (std::size_t k=0; k<rows<W>; ++k) {
+            std::size_t pos = k * bits;
+            std::size_t w = pos / WB;
+            std::size_t off = pos % WB;
+            for (std::size_t l=0; l<L; ++l) {
+                W v = in[k*L + l];
+                out[w*L + l] |= v << off;
+                if (off + bits > WB) {
+                    out[(w+1)*L + l] |= v >> (WB - off);
+                }
+            }
+        }
+    }
+
+    // portable version of the unpacking: the inner loop does the
+    // same for all lanes and can be vectorized by the compiler.
+    // The bit width is a template parameter, so that all shifts
+    // are constants once the outer loop is unrolled
+    template <typename W, unsigned Bits>
+    void unpack_generic(const W* in, W* out) {
+        constexpr std::size_t L = lanes<W>;
+        constexpr std::size_t WB = word_bits<W>;
+        if constexpr (Bits == 0) {
+            std::memset(out, 0, block_size * sizeof(W));
+        } else if constexpr (Bits == WB) {
+            std::memcpy(out, in, block_size * sizeof(W));
+        } else {
+            const W mask = low_bits<W>(Bits);
+#pragma GCC unroll 64
+            for (std::size_t k=0; k<rows<W>; ++k) {
+                const std::size_t w = k * Bits / WB;
+                const std::size_t off = k * Bits % WB;
+                if (off + Bits > WB) {
+                    for (std::size_t l=0; l<L; ++l) {
+                        out[k*L + l] = ((in[w*L + l] >> off)
+                            | (in[(w+1)*L + l] << (WB - off))) & mask;
+                    }
+                } else {
+                    for (std::size_t l=0; l<L; ++l) {
+                        out[k*L + l] = (in[w*L + l] >> off) & mask;
+                    }
+                }
+            }
+        }
+    }
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    // explicit AVX2 version, one register holds one row of the block
+    template <typename W, unsigned Bits>
+    __attribute__((target("avx2")))
+    void unpack_avx2(const W* in, W* out) {
+        constexpr std::size_t L = lanes<W>;
+        constexpr std::size_t WB = word_bits<W>;
+        if constexpr (Bits == 0) {
+            std::memset(out, 0, block_size * sizeof(W));
+        } else if constexpr (Bits == WB) {
+            std::memcpy(out, in, block_size * sizeof(W));
+        } else {
+            __m256i mask;
+            if constexpr (WB == 32) {
+                mask = _mm256_set1_epi32(static_cast<int>(low_bits<W>(Bits)));
+            } else {
+                mask = _mm256_set1_epi64x(static_cast<long long>(low_bits<W>(Bits)));
+            }
+#pragma GCC unroll 64
+            for (std::size_t k=0; k<rows<W>; ++k) {
+                const std::size_t w = k * Bits / WB;
+                const int off = static_cast<int>(k * Bits % WB);
+                __m256i v = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(in + w*L));
+                if constexpr (WB == 32) {
+                    v = _mm256_srli_epi32(v, off);
+                } else {
+                    v = _mm256_srli_epi64(v, off);
+                }
+                if (off + Bits > WB) {
+                    __m256i next = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(in + (w+1)*L));
+                    if constexpr (WB == 32) {
+                        next = _mm256_slli_epi32(next, static_cast<int>(WB) - off);
+                    } else {
+                        next = _mm256_slli_epi64(next, static_cast<int>(WB) - off);
+                    }
+                    v = _mm256_or_si256(v, next);
+                }
+                v = _mm256_and_si256(v, mask);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k*L), v);
+            }
+        }
+    }
+
+    inline bool has_avx2() {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+#endif
+
+    // tables with one kernel per bit width 0..word_bits<W>
+    template <typename W>
+    using kernel = void (*)(const W*, W*);
+
+    template <typename W, unsigned... Bits>
+    constexpr std::array<kernel<W>, sizeof...(Bits)>
+    generic_kernels(std::integer_sequence<unsigned, Bits...>) {
+        return {&unpack_generic<W, Bits>...};
+    }
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    template <typename W, unsigned... Bits>
+    constexpr std::array<kernel<W>, sizeof...(Bits)>
+    avx2_kernels(std::integer_sequence<unsigned, Bits...>) {
+        return {&unpack_avx2<W, Bits>...};
+    }
+#endif
+
+    // picks the kernel for the bit width and the cpu
+    template <typename W>
+    void unpack(const W* in, W* out, unsigned bits) {
+        using widths = std::make_integer_sequence<unsigned, word_bits<W>+1>;
+        static const auto generic = generic_kernels<W>(widths());
+#if defined(__x86_64__) && defined(__GNUC__)
+        static const auto avx2 = avx2_kernels<W>(widths());
+        if (has_avx2()) {
+            avx2[bits](in, out);
+            return;
+        }
+#endif
+        generic[bits](in, out);
+    }
+}
+
+// ############ CompressedBuffer class ##############
+template <typename T>
+requires std::is_integral<T>::value
+class CompressedBuffer {
+    public:
+        // lanes are 32 bits wide for types up to 32 bits
+        using word_type = std::conditional_t<(sizeof(T) <= 4),
+            std::uint32_t, std::uint64_t>;
+        static constexpr std::size_t block_size = bitpack::block_size;
+
+    private:
+        using W = word_type;
+        static constexpr std::size_t L = bitpack::lanes<W>;
+
+        // description of one block
+        struct Block {
+            // first value of the block (delta encoding only)
+            W base;
+            // offset of the packed words of the block
+            std::size_t offset;
+            unsigned bits;
+        };
+
+        std::size_t size_;
+        bool delta_;
+        Buffer<Block> blocks_;
+        Buffer<W, 32> words_;
+
+        // converts the values of block b into the words that are packed;
+        // the last block is padded with its last value
+        void transform(const T* data, std::size_t b, W* out, W& base) const {
+            W v[block_size];
+            std::size_t first = b * block_size;
+            for (std::size_t i=0; i<block_size; ++i) {
+                std::size_t j = first + i < size_ ? first + i : size_ - 1;
+                v[i] = static_cast<W>(data[j]);
+            }
+            base = delta_ ? v[0] : 0;
+            for (std::size_t i=0; i<block_size; ++i) {
+                if (delta_) {
+                    W prev = i < L ? base : v[i-L];
+                    out[i] = bitpack::zigzag<W>(v[i] - prev);
+                } else if (std::is_signed<T>::value) {
+                    out[i] = bitpack::zigzag<W>(v[i]);
+                } else {
+                    out[i] = v[i];
+                }
+            }
+        }
+
+        // inverse of transform on the unpacked words of block b
+        void restore(std::size_t b, const W* in, T* out) const {
+            if (delta_) {
+                W row[L];
+                for (std::size_t l=0; l<L; ++l) {
+                    row[l] = blocks_[b].base;
+                }
+                for (std::size_t k=0; k<bitpack::rows<W>; ++k) {
+                    for (std::size_t l=0; l<L; ++l) {
+                        row[l] += bitpack::unzigzag<W>(in[k*L + l]);
+                        out[k*L + l] = static_cast<T>(row[l]);
+                    }
+                }
+            } else if (std::is_signed<T>::value) {
+                for (std::size_t i=0; i<block_size; ++i) {
+                    out[i] = static_cast<T>(bitpack::unzigzag<W>(in[i]));
+                }
+            } else {
+                for (std::size_t i=0; i<block_size; ++i) {
+                    out[i] = static_cast<T>(in[i]);
+                }
+            }
+        }
+
+        static std::size_t count_blocks(std::size_t n) {
+            return (n + block_size - 1) / block_size;
+        }
+
+        // first pass: bit width and position of every block
+        static std::size_t plan(const CompressedBuffer& c, const T* data,
+            Buffer<Block>& blocks) {
+            std::size_t offset = 0;
+            for (std::size_t b=0; b<blocks.size(); ++b) {
+                W t[block_size];
+                W base;
+                c.transform(data, b, t, base);
+                W all = 0;
+                for (std::size_t i=0; i<block_size; ++i) {
+                    all |= t[i];
+                }
+                blocks[b].base = base;
+                blocks[b].offset = offset;
+                blocks[b].bits = std::bit_width(all);
+                offset += L * blocks[b].bits;
+            }
+            return offset;
+        }
+
+    public:
+        // compresses the elements of 'in'; delta encoding pays off
+        // if neighbouring values are close to each other
+        explicit CompressedBuffer(std::span<const T> in, bool delta = false) :
+            size_(in.size()),
+            delta_(delta),
+            blocks_(count_blocks(in.size())),
+            words_(plan(*this, in.data(), blocks_)) {
+            for (std::size_t b=0; b<blocks_.size(); ++b) {
+                // all-zero or constant-delta block: no words at all
+                if (blocks_[b].bits == 0) {
+                    continue;
+                }
+                W t[block_size];
+                W base;
+                transform(in.data(), b, t, base);
+                bitpack::pack<W>(t, words_.data() + blocks_[b].offset,
+                    blocks_[b].bits);
+            }
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        std::size_t num_blocks() const {
+            return blocks_.size();
+        }
+
+        // memory used by the compressed data
+        std::size_t compressed_bytes() const {
+            return words_.size() * sizeof(W) + blocks_.size() * sizeof(Block);
+        }
+
+        // decodes block b into out, which has room for block_size values
+        void decode_block(std::size_t b, T* out) const {
+            alignas(32) W u[block_size];
+            bitpack::unpack<W>(words_.data() + blocks_[b].offset, u,
+                blocks_[b].bits);
+            restore(b, u, out);
+        }
+
+        // decodes everything into a regular buffer
+        Buffer<T> decompress() const {
+            Buffer<T> out(size_, uninitialized);
+            T tmp[block_size];
+            for (std::size_t b=0; b<blocks_.size(); ++b) {
+                std::size_t first = b * block_size;
+                std::size_t n = size_ - first < block_size ? size_ - first : block_size;
+                if (n == block_size) {
+                    decode_block(b, out.data() + first);
+                } else {
+                    decode_block(b, tmp);
+                    std::copy_n(tmp, n, out.data() + first);
+                }
+            }
+            return out;
+        }
+
+        // calls f(const T* values, std::size_t count) for every block
+        // in order; this is the fastest way to scan, as the inner
+        // loop of f runs over plain memory
+        template <typename Func>
+        void for_each_block(Func f) const {
+            alignas(32) T tmp[block_size];
+            for (std::size_t b=0; b<blocks_.size(); ++b) {
+                std::size_t first = b * block_size;
+                decode_block(b, tmp);
+                f(static_cast<const T*>(tmp),
+                    size_ - first < block_size ? size_ - first : block_size);
+            }
+        }
+
+        // random access to a single element; with delta encoding
+        // this sums up to 'rows' values, so prefer the iterator
+        // for scans
+        T operator[] (std::size_t i) const {
+            constexpr std::size_t WB = bitpack::word_bits<W>;
+            const Block& blk = blocks_[i / block_size];
+            std::size_t r = i % block_size;
+            std::size_t k = r / L;
+            std::size_t l = r % L;
+            const W* in = words_.data() + blk.offset;
+            const W mask = bitpack::low_bits<W>(blk.bits);
+            auto extract = [&](std::size_t row) -> W {
+                if (blk.bits == 0) {
+                    return 0;
+                }
+                std::size_t pos = row * blk.bits;
+                std::size_t w = pos / WB;
+                std::size_t off = pos % WB;
+                W v = in[w*L + l] >> off;
+                if (off + blk.bits > WB) {
+                    v |= in[(w+1)*L + l] << (WB - off);
+                }
+                return v & mask;
+            };
+            if (delta_) {
+                W v = blk.base;
+                for (std::size_t row=0; row<=k; ++row) {
+                    v += bitpack::unzigzag<W>(extract(row));
+                }
+                return static_cast<T>(v);
+            }
+            W v = extract(k);
+            return static_cast<T>(std::is_signed<T>::value ?
+                bitpack::unzigzag<W>(v) : v);
+        }
+
+        // input iterator that decompresses one block at a time
+        // into its own storage while iterating
+        class const_iterator {
+            private:
+                const CompressedBuffer* parent_;
+                std::size_t index_;
+                std::array<T, block_size> block_;
+
+                void load() {
+                    if (index_ < parent_->size_) {
+                        parent_->decode_block(index_ / block_size, block_.data());
+                    }
+                }
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using reference = T;
+                using pointer = void;
+
+                const_iterator() : parent_(nullptr), index_(0) {
+                }
+
+                // decode = false is used for end(), which is
+                // never dereferenced
+                const_iterator(const CompressedBuffer* p, std::size_t i,
+                    bool decode = true) :
+                    parent_(p),
+                    index_(i) {
+                    if (decode) {
+                        load();
+                    }
+                }
+
+                T operator*() const {
+                    return block_[index_ % block_size];
+                }
+
+                const_iterator& operator++() {
+                    ++index_;
+                    if (index_ % block_size == 0) {
+                        load();
+                    }
+                    return *this;
+                }
+
+                void operator++(int) {
+                    ++*this;
+                }
+
+                bool operator==(const const_iterator& other) const {
+                    return index_ == other.index_;
+                }
+        };
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size_, false);
+        }
+};
+
+// ############ Benchmark ##############
+template <typename Func>
+double measure(Func f, std::size_t repetitions) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r=0; r<repetitions; ++r) {
+        f();
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    return dt.count() * 1e3 / repetitions;
+}
+
+template <typename T>
+void compare(const char* name, const Buffer<T>& column, bool delta) {
+    CompressedBuffer<T> c(column, delta);
+
+    // check the round trip
+    Buffer<T> d = c.decompress();
+    bool ok = true;
+    for (std::size_t i=0; i<column.size(); ++i) {
+        ok = ok && d[i] == column[i];
+    }
+    ok = ok && c[column.size()/3] == column[column.size()/3];
+
+    // unsigned sums wrap around instead of overflowing
+    std::uint64_t s1 = 0;
+    std::uint64_t s2 = 0;
+    std::uint64_t s3 = 0;
+    double plain = measure([&]() {
+        s1 = 0;
+        for (T x : column) {
+            s1 += static_cast<std::uint64_t>(x);
+        }
+    }, 5);
+    double iterated = measure([&]() {
+        s2 = 0;
+        for (T x : c) {
+            s2 += static_cast<std::uint64_t>(x);
+        }
+    }, 5);
+    double blocked = measure([&]() {
+        s3 = 0;
+        c.for_each_block([&s3](const T* v, std::size_t count) {
+            std::uint64_t s = 0;
+            for (std::size_t i=0; i<count; ++i) {
+                s += static_cast<std::uint64_t>(v[i]);
+            }
+            s3 += s;
+        });
+    }, 5);
+    ok = ok && s1 == s2 && s1 == s3;
+    std::cout << name << ": " << column.size() * sizeof(T) / (1 << 20)
+        << " MiB -> " << c.compressed_bytes() / (1 << 20) << " MiB" << std::endl
+        << "    scan: plain " << plain << " ms, iterator " << iterated
+        << " ms, for_each_block " << blocked << " ms, "
+        << (ok ? "round trip ok" : "ROUND TRIP FAILED")
+        << std::endl;
+}
+
+
+int main() {
+    const std::size_t n = std::size_t(1) << 25;
+
+    // sorted timestamps with small gaps
+    Buffer<std::int64_t> timestamps(n, uninitialized);
+    std::uint64_t x = 88172645463325252ull;
+    std::int64_t t = 1700000000000;
+    for (auto& v : timestamps) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        t += x % 100;
+        v = t;
+    }
+    compare("int64_t timestamps, delta", timestamps, true);
+
+    // small signed values
+    Buffer<int> small(n, uninitialized);
+    for (auto& v : small) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        v = static_cast<int>(x % 200) - 100;
+    }
+    compare("int in [-100, 100)", small, false);
+
+    // the best cases: blocks without any stored bits
+    Buffer<int> zeros(300);
+    compare("int, all zero", zeros, false);
+    Buffer<std::int64_t> steps(n, uninitialized);
+    for (std::size_t i=0; i<steps.size(); ++i) {
+        steps[i] = 1000 + 5 * static_cast<std::int64_t>(i);
+    }
+    compare("int64_t constant step, delta", steps, true);
+
+    // Fails, only integral types are allowed:
+    //Buffer<double> f(10);
+    //CompressedBuffer<double> cf(f);
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
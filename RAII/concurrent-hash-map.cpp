@@ -0,0 +1,765 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    A std::unordered_map behind a single Lock<std::mutex> lets only one
+    thread at a time access the map, and every thread writes to the
+    cache line of the mutex. This concurrent hash map splits the keys
+    into stripes by their hash:
+        - every stripe has its own mutex and its own table, on its
+          own cache lines, so threads only contend if they access
+          the same stripe
+        - the tables use open addressing (linear probing) in one flat
+          array of key/value slots, so a lookup usually touches only
+          a single cache line instead of following list nodes
+        - a stripe grows on its own when its table is 75% full
+    With the LockFreeReads policy, find() does not take the mutex at
+    all. Every stripe has a sequence number (as the seqlock in
+    "rw-locks.cpp"), readers look up the key optimistically and retry
+    if a writer modified the stripe in the meantime. This needs keys
+    and values that fit into lock-free std::atomic (e.g. integers or
+    pointers). A table is only replaced when it doubles; the replaced
+    tables are kept until the map is destroyed, as a reader might
+    still look at them. They are smaller than the current table
+    together, so this at most doubles the memory usage. Erased slots
+    are cleaned up in place, without a new table.
+
+    The main function measures the throughput for different read/write
+    mixes and thread counts.
+*/
+
+#include <mutex>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <functional>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <system_error>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// ############ Tracing policies ##############
+// A policy performs the locking and unlocking of the resource and
+// may record something around it:
+//     lock(r)    acquires r (blocking)
+//     unlock(r)  releases r
+//     locked(r)  r was acquired by try_lock, a timed lock or adopted
+// The Lock derives from its policy, so a policy may keep state per
+// Lock object, and an empty policy does not take any space.
+
+// the default policy does nothing else and is optimized away completely
+struct NoTracing {
+    template <typename T>
+    void lock(T& r) {
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+    }
+
+    template <typename T>
+    void locked(T&) {
+    }
+};
+
+
+// Lock without I/O; [[nodiscard]] at the constructors makes the
+// compiler warn about "Lock<std::mutex>{m};", which unlocks again
+// immediately (the attribute at the class covers functions that
+// return a Lock)
+template <typename T, typename Tracing = NoTracing>
+class [[nodiscard]] Lock : private Tracing {
+    private:
+        // a pointer instead of a reference, as a moved-from
+        // Lock does not refer to any resource
+        T* resource;
+        bool owns;
+
+    public:
+        // constructor locks the resource
+        [[nodiscard]] explicit Lock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        // only stores the resource, lock() is called later
+        Lock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        // does not block, check owns_lock() afterwards
+        [[nodiscard]] Lock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        // the resource is already locked by the calling thread
+        Lock(T& r, std::adopt_lock_t) : resource(&r), owns(true) {
+            Tracing::locked(*resource);
+        }
+
+        // waits at most for the given time (e.g. std::timed_mutex)
+        template <typename Rep, typename Period>
+        [[nodiscard]] Lock(T& r, const std::chrono::duration<Rep, Period>& timeout) :
+            resource(&r), owns(false) {
+            (void)try_lock_for(timeout);
+        }
+
+        // waits at most until the given point in time
+        template <typename Clock, typename Duration>
+        [[nodiscard]] Lock(T& r, const std::chrono::time_point<Clock, Duration>& deadline) :
+            resource(&r), owns(false) {
+            (void)try_lock_until(deadline);
+        }
+
+        // destructor releases the resource if it is owned
+        ~Lock() {
+            if (owns) {
+                unlock();
+            }
+        }
+
+        // the ownership can be passed on, but not copied
+        Lock(Lock&& other) noexcept :
+            Tracing(std::move(static_cast<Tracing&>(other))),
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        Lock& operator=(Lock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    unlock();
+                }
+                static_cast<Tracing&>(*this) = std::move(static_cast<Tracing&>(other));
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        // same errors as std::unique_lock
+        void lock() {
+            check();
+            Tracing::lock(*resource);
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock();
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+            check();
+            owns = resource->try_lock_for(timeout);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Clock, typename Duration>
+        [[nodiscard]] bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+            check();
+            owns = resource->try_lock_until(deadline);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            Tracing::unlock(*resource);
+        }
+
+        // gives up the ownership without unlocking
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// ############ Concurrent hash map ##############
+constexpr std::size_t cacheline_size = 64;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// read policies of the map
+struct LockedReads {
+    static constexpr bool lock_free = false;
+};
+
+struct LockFreeReads {
+    static constexpr bool lock_free = true;
+};
+
+// a field of a slot; with lock-free reads every field is a relaxed
+// atomic, since readers may look at it while it is written
+template <typename T, bool Atomic>
+class Cell {
+    private:
+        T value{};
+
+    public:
+        const T& load() const {
+            return value;
+        }
+
+        void store(T v) {
+            value = std::move(v);
+        }
+};
+
+template <typename T>
+class Cell<T, true> {
+    private:
+        std::atomic<T> value{};
+
+    public:
+        T load() const {
+            return value.load(std::memory_order_relaxed);
+        }
+
+        void store(T v) {
+            value.store(v, std::memory_order_relaxed);
+        }
+};
+
+// std::atomic<T> must not even be named for other types
+template <typename T>
+constexpr bool fits_lock_free_atomic() {
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        return std::atomic<T>::is_always_lock_free;
+    } else {
+        return false;
+    }
+}
+
+// K and V have to be default constructible, erased slots
+// are reset to default values
+template <typename K, typename V, typename Reads = LockedReads,
+    typename Mutex = std::mutex, typename Hash = std::hash<K>>
+class ConcurrentHashMap {
+    private:
+        static constexpr bool lock_free = Reads::lock_free;
+        static_assert(!lock_free || (fits_lock_free_atomic<K>()
+            && fits_lock_free_atomic<V>()),
+            "lock-free reads need keys and values that fit into lock-free atomics");
+
+        enum State : std::uint8_t { empty, full, erased };
+
+        struct Slot {
+            Cell<std::uint8_t, lock_free> state;
+            Cell<K, lock_free> key;
+            Cell<V, lock_free> value;
+        };
+
+        struct Table {
+            std::size_t mask;
+            std::unique_ptr<Slot[]> slots;
+
+            explicit Table(std::size_t capacity) :
+                mask(capacity - 1), slots(new Slot[capacity]) {
+            }
+        };
+
+        struct alignas(cacheline_size) Stripe {
+            Mutex mutex;
+            // odd while a writer modifies the stripe (lock-free reads)
+            std::atomic<std::uint64_t> version{0};
+            std::atomic<Table*> table{nullptr};
+            std::unique_ptr<Table> current;
+            std::vector<std::unique_ptr<Table>> retired;
+            // full slots and full + erased slots
+            std::size_t size = 0;
+            std::size_t used = 0;
+        };
+
+        // exclusive access to a stripe; with lock-free reads the
+        // version is odd as long as the writer is inside
+        class Writer {
+            private:
+                Lock<Mutex> lock;
+                Stripe& stripe;
+
+            public:
+                explicit Writer(Stripe& s) : lock(s.mutex), stripe(s) {
+                    if constexpr (lock_free) {
+                        stripe.version.store(stripe.version.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+                        std::atomic_thread_fence(std::memory_order_release);
+                    }
+                }
+
+                ~Writer() {
+                    if constexpr (lock_free) {
+                        stripe.version.store(stripe.version.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_release);
+                    }
+                }
+
+                Writer(const Writer&) = delete;
+                Writer& operator=(const Writer&) = delete;
+        };
+
+        std::size_t stripe_mask;
+        std::unique_ptr<Stripe[]> stripes;
+        Hash hasher;
+
+        // std::hash of integers is the identity, so the bits are
+        // mixed (finalizer of MurmurHash3) before they are split
+        // into stripe (upper half) and slot index (lower half)
+        std::uint64_t hash(const K& key) const {
+            std::uint64_t h = hasher(key);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        Stripe& stripe_of(std::uint64_t h) const {
+            return stripes[(h >> 32) & stripe_mask];
+        }
+
+        // slot with the key or nullptr; at most one round through the
+        // table, as a lock-free reader might see an inconsistent one
+        static const Slot* lookup(const Table& t, const K& key, std::uint64_t h) {
+            std::size_t i = h & t.mask;
+            for (std::size_t n=0; n<=t.mask; ++n, i=(i+1) & t.mask) {
+                const std::uint8_t state = t.slots[i].state.load();
+                if (state == empty) {
+                    return nullptr;
+                }
+                if (state == full && t.slots[i].key.load() == key) {
+                    return &t.slots[i];
+                }
+            }
+            return nullptr;
+        }
+
+        // inserts an entry that is not in the table yet (rehash only)
+        void place(Table& t, const K& key, const V& value) const {
+            std::size_t j = hash(key) & t.mask;
+            while (t.slots[j].state.load() != empty) {
+                j = (j + 1) & t.mask;
+            }
+            t.slots[j].key.store(key);
+            t.slots[j].value.store(value);
+            t.slots[j].state.store(full);
+        }
+
+        // Doubles the table if it is really filled. Otherwise it is
+        // full of erased slots, which are cleaned in place: the writer
+        // holds the stripe, so lock-free readers see an odd version
+        // and retry, and the table stays valid for them. Only a
+        // replaced (smaller) table has to be retired.
+        void rehash(Stripe& s) {
+            const std::size_t capacity = s.current->mask + 1;
+            if (4*s.size < 2*capacity) {
+                std::vector<std::pair<K, V>> entries;
+                entries.reserve(s.size);
+                for (std::size_t i=0; i<capacity; ++i) {
+                    Slot& slot = s.current->slots[i];
+                    if (slot.state.load() == full) {
+                        entries.emplace_back(slot.key.load(), slot.value.load());
+                    }
+                    slot.state.store(empty);
+                    slot.key.store(K{});
+                    slot.value.store(V{});
+                }
+                for (const auto& [key, value] : entries) {
+                    place(*s.current, key, value);
+                }
+                s.used = s.size;
+                return;
+            }
+            auto table = std::make_unique<Table>(2*capacity);
+            for (std::size_t i=0; i<capacity; ++i) {
+                const Slot& from = s.current->slots[i];
+                if (from.state.load() == full) {
+                    place(*table, from.key.load(), from.value.load());
+                }
+            }
+            s.used = s.size;
+            s.table.store(table.get(), std::memory_order_release);
+            if constexpr (lock_free) {
+                s.retired.push_back(std::move(s.current));
+            }
+            s.current = std::move(table);
+        }
+
+        // slot for the key (under the stripe lock); the key is
+        // inserted with a default value if it is not there yet
+        Slot& slot_for(Stripe& s, const K& key, std::uint64_t h, bool& inserted) {
+            if (4*(s.used + 1) > 3*(s.current->mask + 1)) {
+                rehash(s);
+            }
+            Table& t = *s.current;
+            Slot* reuse = nullptr;
+            std::size_t i = h & t.mask;
+            for (;; i=(i+1) & t.mask) {
+                const std::uint8_t state = t.slots[i].state.load();
+                if (state == full && t.slots[i].key.load() == key) {
+                    inserted = false;
+                    return t.slots[i];
+                }
+                if (state == erased && reuse == nullptr) {
+                    reuse = &t.slots[i];
+                }
+                if (state == empty) {
+                    break;
+                }
+            }
+            Slot& slot = reuse != nullptr ? *reuse : t.slots[i];
+            if (reuse == nullptr) {
+                ++s.used;
+            }
+            ++s.size;
+            slot.key.store(key);
+            slot.state.store(full);
+            inserted = true;
+            return slot;
+        }
+
+    public:
+        // the number of stripes is rounded up to a power of two
+        explicit ConcurrentHashMap(std::size_t stripe_count = 64,
+            std::size_t initial_capacity = 16) {
+            std::size_t n = 1;
+            while (n < stripe_count) {
+                n *= 2;
+            }
+            std::size_t capacity = 16;
+            while (capacity < initial_capacity) {
+                capacity *= 2;
+            }
+            stripe_mask = n - 1;
+            stripes = std::make_unique<Stripe[]>(n);
+            for (std::size_t i=0; i<n; ++i) {
+                stripes[i].current = std::make_unique<Table>(capacity);
+                stripes[i].table.store(stripes[i].current.get(), std::memory_order_relaxed);
+            }
+        }
+
+        ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+        ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+        // copy of the value, if the key is there
+        std::optional<V> find(const K& key) const {
+            const std::uint64_t h = hash(key);
+            Stripe& s = stripe_of(h);
+            if constexpr (lock_free) {
+                unsigned rounds = 0;
+                for (;; ++rounds) {
+                    if (rounds > 64) {
+                        std::this_thread::yield();
+                    }
+                    const std::uint64_t before = s.version.load(std::memory_order_acquire);
+                    if (before & 1) {
+                        cpu_relax();
+                        continue;
+                    }
+                    std::optional<V> result;
+                    const Table* t = s.table.load(std::memory_order_acquire);
+                    if (const Slot* slot = lookup(*t, key, h)) {
+                        result = slot->value.load();
+                    }
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (s.version.load(std::memory_order_relaxed) == before) {
+                        return result;
+                    }
+                }
+            } else {
+                Lock<Mutex> lock(s.mutex);
+                if (const Slot* slot = lookup(*s.current, key, h)) {
+                    return slot->value.load();
+                }
+                return std::nullopt;
+            }
+        }
+
+        bool contains(const K& key) const {
+            return find(key).has_value();
+        }
+
+        // returns true if the key was inserted, false if it was assigned
+        bool insert_or_assign(const K& key, V value) {
+            const std::uint64_t h = hash(key);
+            Stripe& s = stripe_of(h);
+            Writer writer(s);
+            bool inserted;
+            slot_for(s, key, h, inserted).value.store(std::move(value));
+            return inserted;
+        }
+
+        // only inserts if the key is not there yet
+        bool insert(const K& key, V value) {
+            const std::uint64_t h = hash(key);
+            Stripe& s = stripe_of(h);
+            Writer writer(s);
+            bool inserted;
+            Slot& slot = slot_for(s, key, h, inserted);
+            if (inserted) {
+                slot.value.store(std::move(value));
+            }
+            return inserted;
+        }
+
+        // calls f with a copy of the value (a default value for new
+        // keys) and stores the result, atomically for this key
+        template <typename F>
+        void update(const K& key, F f) {
+            const std::uint64_t h = hash(key);
+            Stripe& s = stripe_of(h);
+            Writer writer(s);
+            bool inserted;
+            Slot& slot = slot_for(s, key, h, inserted);
+            V value = slot.value.load();
+            f(value);
+            slot.value.store(std::move(value));
+        }
+
+        bool erase(const K& key) {
+            const std::uint64_t h = hash(key);
+            Stripe& s = stripe_of(h);
+            Writer writer(s);
+            Slot* slot = const_cast<Slot*>(lookup(*s.current, key, h));
+            if (slot == nullptr) {
+                return false;
+            }
+            slot->state.store(erased);
+            slot->key.store(K{});
+            slot->value.store(V{});
+            --s.size;
+            return true;
+        }
+
+        // sum over the stripes, one after the other; only exact
+        // if no other thread modifies the map
+        std::size_t size() const {
+            std::size_t n = 0;
+            for (std::size_t i=0; i<=stripe_mask; ++i) {
+                Lock<Mutex> lock(stripes[i].mutex);
+                n += stripes[i].size;
+            }
+            return n;
+        }
+};
+
+// ############ Benchmark ##############
+// the baseline: one map, one mutex
+template <typename K, typename V>
+class SingleLockMap {
+    private:
+        mutable std::mutex m;
+        std::unordered_map<K, V> map;
+
+    public:
+        std::optional<V> find(const K& key) const {
+            Lock<std::mutex> lock(m);
+            auto it = map.find(key);
+            if (it == map.end()) {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        bool insert_or_assign(const K& key, V value) {
+            Lock<std::mutex> lock(m);
+            return map.insert_or_assign(key, std::move(value)).second;
+        }
+
+        bool erase(const K& key) {
+            Lock<std::mutex> lock(m);
+            return map.erase(key) > 0;
+        }
+};
+
+// xorshift, a fast random generator for the keys
+struct Random {
+    std::uint64_t state;
+
+    std::uint64_t operator()() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+constexpr std::uint64_t key_count = 1 << 16;
+
+// every thread runs random operations for a fixed time: reads in
+// read_percent of the cases, otherwise assignments and erases in
+// equal parts; returns million operations per second
+template <typename Map>
+double run(std::size_t threads, unsigned read_percent) {
+    using namespace std::chrono_literals;
+    constexpr auto duration = 200ms;
+    Map map;
+    for (std::uint64_t k=0; k<key_count; ++k) {
+        map.insert_or_assign(k, k);
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> operations{0};
+    std::atomic<std::uint64_t> hits{0};
+
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t<threads; ++t) {
+        workers.emplace_back([&, t]() {
+            Random random{0x9e3779b97f4a7c15ULL * (t + 1)};
+            std::uint64_t n = 0;
+            std::uint64_t found = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const std::uint64_t r = random();
+                const std::uint64_t key = r % key_count;
+                const unsigned choice = (r >> 32) % 200;
+                if (choice < 2*read_percent) {
+                    found += map.find(key).has_value();
+                } else if (choice % 2 == 0) {
+                    map.insert_or_assign(key, r);
+                } else {
+                    map.erase(key);
+                }
+                ++n;
+            }
+            operations.fetch_add(n, std::memory_order_relaxed);
+            hits.fetch_add(found, std::memory_order_relaxed);
+        });
+    }
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    for (auto& w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> seconds = duration;
+    return operations.load() / seconds.count() / 1e6;
+}
+
+
+int main() {
+    // any key type with std::hash works with locked reads
+    ConcurrentHashMap<std::string, int> cache;
+    cache.insert_or_assign("alpha", 1);
+    cache.insert("beta", 2);
+    cache.update("alpha", [](int& v) { v += 10; });
+    cache.erase("beta");
+    std::cout << "alpha: " << cache.find("alpha").value_or(-1)
+        << ", beta: " << cache.find("beta").value_or(-1)
+        << ", size: " << cache.size() << std::endl;
+
+    std::size_t max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads=1; threads<max_threads; threads*=2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    using Single = SingleLockMap<std::uint64_t, std::uint64_t>;
+    using Striped = ConcurrentHashMap<std::uint64_t, std::uint64_t>;
+    using StripedLockFree = ConcurrentHashMap<std::uint64_t, std::uint64_t, LockFreeReads>;
+
+    std::cout << "million operations per second, " << key_count << " keys ("
+        << std::thread::hardware_concurrency() << " cores)" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(8) << "reads"
+        << std::setw(14) << "single lock" << std::setw(10) << "striped"
+        << std::setw(20) << "striped, lock-free" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (std::size_t threads : thread_counts) {
+        for (unsigned read_percent : {100u, 90u, 50u}) {
+            std::cout << std::setw(8) << threads << std::setw(7) << read_percent << "%"
+                << std::setw(14) << run<Single>(threads, read_percent)
+                << std::setw(10) << run<Striped>(threads, read_percent)
+                << std::setw(20) << run<StripedLockFree>(threads, read_percent)
+                << std::endl;
+        }
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
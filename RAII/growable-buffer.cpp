@@ -0,0 +1,337 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    This is an extension of the file "memory-management.cpp" for
+    buffers whose final size is not known in advance, e.g. when
+    data is appended as it arrives. The class manages its memory
+    with the C functions malloc/calloc/realloc and, for large sizes,
+    directly with mmap/mremap (Linux).
+
+    Like std::vector, the capacity grows geometrically (doubling),
+    so appending an element costs amortized constant time. The
+    difference lies in how the memory grows:
+        - std::vector always allocates a new block, copies (or moves)
+          all elements over and frees the old block
+        - for trivially copyable types, the bytes of an element can be
+          relocated by the allocator itself: realloc can often extend
+          a block in place, and mremap moves a large mapping to its
+          new size by rewriting page table entries, without touching
+          a single byte of the data
+    Buffers below one MiB live on the malloc heap, larger ones in
+    their own anonymous mapping. Other types fall back to the
+    vector strategy (allocate, move, destroy).
+
+    Zeroed buffers of trivial types are created with calloc or mmap:
+    freshly mapped pages are zero and only get physical memory when
+    they are written, instead of being written once with zeros.
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include <sys/mman.h>
+
+// tag type to select the constructor that zeroes the elements
+struct zeroed_t {
+    explicit zeroed_t() = default;
+};
+constexpr zeroed_t zeroed{};
+
+template <typename T>
+class GrowableBuffer {
+    // types whose bytes can be moved around with realloc/mremap
+    static constexpr bool relocatable = std::is_trivially_copyable<T>::value;
+    static_assert(!relocatable || alignof(T) <= alignof(std::max_align_t),
+        "malloc does not provide the alignment of T");
+
+    // buffers of at least this size are mapped directly
+    static constexpr std::size_t mmap_threshold = std::size_t(1) << 20;
+    static constexpr std::size_t page_size = 4096;
+
+    private:
+        std::size_t size_;
+        std::size_t capacity_;
+        T* data_;
+        // true if data_ is an anonymous mapping, otherwise it
+        // comes from malloc (or operator new if !relocatable)
+        bool mapped_;
+
+        static std::size_t page_round(std::size_t bytes) {
+            return (bytes + page_size - 1) / page_size * page_size;
+        }
+
+        static void* map(std::size_t bytes) {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+
+        // relocating growth for trivially copyable types
+        void regrow(std::size_t new_cap) {
+            std::size_t old_bytes = capacity_ * sizeof(T);
+            std::size_t new_bytes = new_cap * sizeof(T);
+            void* p;
+            if (new_bytes < mmap_threshold) {
+                p = std::realloc(data_, new_bytes);
+                if (p == nullptr) {
+                    throw std::bad_alloc();
+                }
+            } else if (mapped_) {
+                new_bytes = page_round(new_bytes);
+                p = mremap(data_, page_round(old_bytes), new_bytes, MREMAP_MAYMOVE);
+                if (p == MAP_FAILED) {
+                    throw std::bad_alloc();
+                }
+            } else {
+                // crossing the threshold copies once (less than 1 MiB)
+                new_bytes = page_round(new_bytes);
+                p = map(new_bytes);
+                if (size_ > 0) {
+                    std::memcpy(p, data_, size_ * sizeof(T));
+                }
+                std::free(data_);
+                mapped_ = true;
+            }
+            data_ = static_cast<T*>(p);
+            // a mapping may have room for a few more elements
+            capacity_ = new_bytes / sizeof(T);
+        }
+
+        // growth for all other types, same as std::vector
+        void move_to(std::size_t new_cap) {
+            T* p = static_cast<T*>(::operator new(new_cap * sizeof(T),
+                std::align_val_t(alignof(T))));
+            try {
+                std::uninitialized_move_n(data_, size_, p);
+            } catch (...) {
+                ::operator delete(p, std::align_val_t(alignof(T)));
+                throw;
+            }
+            std::destroy_n(data_, size_);
+            ::operator delete(data_, std::align_val_t(alignof(T)));
+            data_ = p;
+            capacity_ = new_cap;
+        }
+
+        void grow_to(std::size_t new_cap) {
+            if constexpr (relocatable) {
+                regrow(new_cap);
+            } else {
+                move_to(new_cap);
+            }
+        }
+
+        void release() {
+            std::destroy_n(data_, size_);
+            if constexpr (relocatable) {
+                if (mapped_) {
+                    munmap(data_, page_round(capacity_ * sizeof(T)));
+                } else {
+                    std::free(data_);
+                }
+            } else {
+                ::operator delete(data_, std::align_val_t(alignof(T)));
+            }
+        }
+
+    public:
+        // an empty buffer does not allocate anything
+        GrowableBuffer() :
+            size_(0),
+            capacity_(0),
+            data_(nullptr),
+            mapped_(false) {
+        }
+
+        // s elements with all bytes zero; small buffers use calloc,
+        // large ones fresh pages, which are zero without any writes
+        GrowableBuffer(std::size_t s, zeroed_t) :
+            GrowableBuffer() {
+            static_assert(std::is_trivial<T>::value,
+                "zeroed buffers require a trivial type");
+            std::size_t bytes = s * sizeof(T);
+            if (bytes < mmap_threshold) {
+                data_ = static_cast<T*>(std::calloc(s > 0 ? s : 1, sizeof(T)));
+                if (data_ == nullptr) {
+                    throw std::bad_alloc();
+                }
+                capacity_ = s;
+            } else {
+                bytes = page_round(bytes);
+                data_ = static_cast<T*>(map(bytes));
+                mapped_ = true;
+                capacity_ = bytes / sizeof(T);
+            }
+            size_ = s;
+        }
+
+        ~GrowableBuffer() {
+            release();
+        }
+
+        GrowableBuffer(GrowableBuffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            capacity_(std::exchange(other.capacity_, 0)),
+            data_(std::exchange(other.data_, nullptr)),
+            mapped_(std::exchange(other.mapped_, false)) {
+        }
+
+        GrowableBuffer& operator=(GrowableBuffer&& other) noexcept {
+            if (this != &other) {
+                release();
+                size_ = std::exchange(other.size_, 0);
+                capacity_ = std::exchange(other.capacity_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+                mapped_ = std::exchange(other.mapped_, false);
+            }
+            return *this;
+        }
+
+        // makes room for at least n elements
+        void reserve(std::size_t n) {
+            if (n > capacity_) {
+                grow_to(n);
+            }
+        }
+
+        // the argument is taken by value, as it might refer to an
+        // element of this buffer that is relocated by the growth
+        void push_back(T value) {
+            if (size_ == capacity_) {
+                grow_to(capacity_ > 0 ? 2*capacity_ : 16);
+            }
+            ::new (data_ + size_) T(std::move(value));
+            ++size_;
+        }
+
+        // new elements are value initialized
+        void resize(std::size_t n) {
+            if (n > capacity_) {
+                grow_to(n > 2*capacity_ ? n : 2*capacity_);
+            }
+            if (n > size_) {
+                std::uninitialized_value_construct(data_ + size_, data_ + n);
+            } else {
+                std::destroy(data_ + n, data_ + size_);
+            }
+            size_ = n;
+        }
+
+        void clear() {
+            std::destroy_n(data_, size_);
+            size_ = 0;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        size_t size() {
+            return size_;
+        }
+
+        size_t capacity() {
+            return capacity_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        GrowableBuffer(const GrowableBuffer&) = delete;
+        GrowableBuffer& operator=(const GrowableBuffer&) = delete;
+};
+
+// ############ Benchmark ##############
+template <typename Container>
+double append(std::size_t n, std::size_t& moves) {
+    auto start = std::chrono::steady_clock::now();
+    Container c;
+    const int* last = nullptr;
+    moves = 0;
+    for (std::size_t i=0; i<n; ++i) {
+        c.push_back(static_cast<int>(i));
+        // count how often the memory changed its address
+        if (c.data() != last) {
+            ++moves;
+            last = c.data();
+        }
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    if (c[n/2] != static_cast<int>(n/2)) {
+        std::cout << "wrong result" << std::endl;
+    }
+    return dt.count();
+}
+
+
+int main() {
+    // non-trivial types take the std::vector path
+    GrowableBuffer<std::string> s;
+    for (int i=0; i<100; ++i) {
+        s.push_back(std::to_string(i));
+    }
+    std::cout << "s[42] = " << s[42] << std::endl;
+
+    // zeroed buffer of 1 GiB: only the page table is set up,
+    // the pages themselves are allocated when written
+    auto start = std::chrono::steady_clock::now();
+    GrowableBuffer<double> z(std::size_t(1) << 27, zeroed);
+    z[12345] = 1.0;
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    std::cout << "zeroed GrowableBuffer of 1 GiB: " << dt.count()*1e3 << " ms"
+        << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<double> zv(std::size_t(1) << 27);
+    zv[12345] = 1.0;
+    dt = std::chrono::steady_clock::now() - start;
+    std::cout << "std::vector of 1 GiB: " << dt.count()*1e3 << " ms" << std::endl;
+
+    // appending
+    for (std::size_t n : {std::size_t(1) << 16, std::size_t(1) << 22,
+            std::size_t(1) << 27}) {
+        std::size_t vmoves, gmoves;
+        double tv = append<std::vector<int>>(n, vmoves);
+        double tg = append<GrowableBuffer<int>>(n, gmoves);
+        std::cout << "push_back of " << n << " ints: std::vector "
+            << tv*1e3 << " ms (" << vmoves << " relocations), GrowableBuffer "
+            << tg*1e3 << " ms (" << gmoves << " relocations), speedup "
+            << tv/tg << std::endl;
+    }
+}
@@ -0,0 +1,577 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    This is an extension of the file "mutex-lock.cpp" with a tracing
+    policy for the Lock class that answers the question "which mutex
+    is the bottleneck?". For every named lock site it records
+        - the number of acquisitions
+        - how many of them were contended, i.e. the mutex was held
+          by another thread and the caller had to wait
+        - histograms of the waiting time and of the time the mutex
+          was held (powers of two)
+    and prints the top N sites sorted by the total waiting time.
+
+    A lock site is a small struct with a name that is given to the
+    policy as template parameter:
+        struct routing_site { static constexpr const char* name = "routing"; };
+        Lock<std::mutex, Profiling<routing_site>> lock(m);
+
+    Times are taken from the time stamp counter of the cpu (rdtsc),
+    which takes a few nanoseconds, and only converted to nanoseconds
+    in the report. An uncontended acquisition reads it twice (begin
+    and end of the hold time), a contended one three times.
+    Contention is detected with a try_lock before the blocking lock.
+    The counters are kept per thread and per site and are summed up
+    only for a report; they are written after the mutex has been
+    released, so the critical section itself only grows by reading
+    the time stamp counter. This keeps the policy cheap enough to be
+    left on in production.
+*/
+
+#include <mutex>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ############ Tracing policies ##############
+// A policy performs the locking and unlocking of the resource and
+// may record something around it:
+//     lock(r)    acquires r (blocking)
+//     unlock(r)  releases r
+//     locked(r)  r was acquired by try_lock, a timed lock or adopted
+// The Lock derives from its policy, so a policy may keep state per
+// Lock object, and an empty policy does not take any space.
+
+// the default policy does nothing else and is optimized away completely
+struct NoTracing {
+    template <typename T>
+    void lock(T& r) {
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+    }
+
+    template <typename T>
+    void locked(T&) {
+    }
+};
+
+// Lock without I/O; [[nodiscard]] at the constructors makes the
+// compiler warn about "Lock<std::mutex>{m};", which unlocks again
+// immediately (the attribute at the class covers functions that
+// return a Lock)
+template <typename T, typename Tracing = NoTracing>
+class [[nodiscard]] Lock : private Tracing {
+    private:
+        // a pointer instead of a reference, as a moved-from
+        // Lock does not refer to any resource
+        T* resource;
+        bool owns;
+
+    public:
+        // constructor locks the resource
+        [[nodiscard]] explicit Lock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        // only stores the resource, lock() is called later
+        Lock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        // does not block, check owns_lock() afterwards
+        [[nodiscard]] Lock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        // the resource is already locked by the calling thread
+        Lock(T& r, std::adopt_lock_t) : resource(&r), owns(true) {
+            Tracing::locked(*resource);
+        }
+
+        // waits at most for the given time (e.g. std::timed_mutex)
+        template <typename Rep, typename Period>
+        [[nodiscard]] Lock(T& r, const std::chrono::duration<Rep, Period>& timeout) :
+            resource(&r), owns(false) {
+            (void)try_lock_for(timeout);
+        }
+
+        // waits at most until the given point in time
+        template <typename Clock, typename Duration>
+        [[nodiscard]] Lock(T& r, const std::chrono::time_point<Clock, Duration>& deadline) :
+            resource(&r), owns(false) {
+            (void)try_lock_until(deadline);
+        }
+
+        // destructor releases the resource if it is owned
+        ~Lock() {
+            if (owns) {
+                unlock();
+            }
+        }
+
+        // the ownership can be passed on, but not copied
+        Lock(Lock&& other) noexcept :
+            Tracing(std::move(static_cast<Tracing&>(other))),
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        Lock& operator=(Lock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    unlock();
+                }
+                static_cast<Tracing&>(*this) = std::move(static_cast<Tracing&>(other));
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        // same errors as std::unique_lock
+        void lock() {
+            check();
+            Tracing::lock(*resource);
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock();
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+            check();
+            owns = resource->try_lock_for(timeout);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Clock, typename Duration>
+        [[nodiscard]] bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+            check();
+            owns = resource->try_lock_until(deadline);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            Tracing::unlock(*resource);
+        }
+
+        // gives up the ownership without unlocking
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// ############ Profiling policy ##############
+namespace profiling {
+    // time in ticks of the time stamp counter (or nanoseconds)
+    inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // ticks per nanosecond, measured once
+    inline double ticks_per_ns() {
+        static const double f = []() {
+            auto t0 = std::chrono::steady_clock::now();
+            std::uint64_t c0 = ticks();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::uint64_t c1 = ticks();
+            std::chrono::duration<double, std::nano> dt =
+                std::chrono::steady_clock::now() - t0;
+            return (c1 - c0) / dt.count();
+        }();
+        return f;
+    }
+
+    // bucket b counts times below 2^b ticks
+    constexpr std::size_t buckets = 48;
+
+    inline std::size_t bucket(std::uint64_t t) {
+        std::size_t b = 0;
+        while (b < buckets-1 && (std::uint64_t(1) << b) <= t) {
+            ++b;
+        }
+        return b;
+    }
+
+    // written by one thread, read by the report
+    struct Counter {
+        std::atomic<std::uint64_t> value{0};
+
+        void add(std::uint64_t x) {
+            value.store(value.load(std::memory_order_relaxed) + x,
+                std::memory_order_relaxed);
+        }
+
+        std::uint64_t get() const {
+            return value.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct Counters {
+        Counter acquisitions;
+        Counter contended;
+        Counter wait_ticks;
+        Counter hold_ticks;
+        Counter wait[buckets];
+        Counter hold[buckets];
+    };
+
+    // plain sums of Counters, used for the report
+    struct Totals {
+        std::uint64_t acquisitions = 0;
+        std::uint64_t contended = 0;
+        std::uint64_t wait_ticks = 0;
+        std::uint64_t hold_ticks = 0;
+        std::uint64_t wait[buckets] = {};
+        std::uint64_t hold[buckets] = {};
+
+        void add(const Counters& c) {
+            acquisitions += c.acquisitions.get();
+            contended += c.contended.get();
+            wait_ticks += c.wait_ticks.get();
+            hold_ticks += c.hold_ticks.get();
+            for (std::size_t b=0; b<buckets; ++b) {
+                wait[b] += c.wait[b].get();
+                hold[b] += c.hold[b].get();
+            }
+        }
+    };
+
+    struct ThreadCounters;
+
+    // shared state of one lock site
+    struct SiteState {
+        const char* name;
+        std::mutex mutex;
+        ThreadCounters* threads = nullptr;
+        // counters of terminated threads
+        Totals retired;
+        SiteState* next = nullptr;
+
+        explicit SiteState(const char* n);
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        SiteState* sites = nullptr;
+    };
+
+    inline Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    inline SiteState::SiteState(const char* n) : name(n) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        next = r.sites;
+        r.sites = this;
+    }
+
+    // counters of one thread for one site
+    struct ThreadCounters : Counters {
+        SiteState& site;
+        ThreadCounters* next;
+
+        explicit ThreadCounters(SiteState& s) : site(s) {
+            std::lock_guard<std::mutex> lock(site.mutex);
+            next = site.threads;
+            site.threads = this;
+        }
+
+        ~ThreadCounters() {
+            std::lock_guard<std::mutex> lock(site.mutex);
+            site.retired.add(*this);
+            ThreadCounters** p = &site.threads;
+            while (*p != this) {
+                p = &(*p)->next;
+            }
+            *p = next;
+        }
+    };
+
+    template <typename Site>
+    SiteState& site_state() {
+        static SiteState s(Site::name);
+        return s;
+    }
+
+    template <typename Site>
+    ThreadCounters& thread_counters() {
+        thread_local ThreadCounters c(site_state<Site>());
+        return c;
+    }
+
+    // upper bound (in ns) of the time below which a fraction q of
+    // all entries of the histogram lie
+    inline double percentile(const std::uint64_t* hist, double q) {
+        std::uint64_t total = 0;
+        for (std::size_t b=0; b<buckets; ++b) {
+            total += hist[b];
+        }
+        std::uint64_t seen = 0;
+        for (std::size_t b=0; b<buckets; ++b) {
+            seen += hist[b];
+            if (total > 0 && seen >= q * total) {
+                return (std::uint64_t(1) << b) / ticks_per_ns();
+            }
+        }
+        return 0.0;
+    }
+
+    // prints the n sites with the largest total waiting time
+    inline void report(std::ostream& out, std::size_t n) {
+        std::vector<std::pair<const char*, Totals>> sites;
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (SiteState* s=r.sites; s!=nullptr; s=s->next) {
+                std::lock_guard<std::mutex> site_lock(s->mutex);
+                Totals t = s->retired;
+                for (ThreadCounters* c=s->threads; c!=nullptr; c=c->next) {
+                    t.add(*c);
+                }
+                sites.emplace_back(s->name, t);
+            }
+        }
+        std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) {
+            return a.second.wait_ticks > b.second.wait_ticks;
+        });
+        const double f = ticks_per_ns();
+        out << "---- lock contention report ----" << std::endl
+            << std::setw(16) << "site" << std::setw(12) << "acquired"
+            << std::setw(11) << "contended" << std::setw(14) << "wait total"
+            << std::setw(12) << "wait p50" << std::setw(12) << "wait p99"
+            << std::setw(12) << "hold mean" << std::setw(12) << "hold p99"
+            << std::endl;
+        for (std::size_t i=0; i<sites.size() && i<n; ++i) {
+            const Totals& t = sites[i].second;
+            double mean_hold = t.acquisitions > 0 ?
+                t.hold_ticks / f / t.acquisitions : 0.0;
+            out << std::setw(16) << sites[i].first
+                << std::setw(12) << t.acquisitions
+                << std::setw(10) << std::fixed << std::setprecision(1)
+                << (t.acquisitions > 0 ? 100.0 * t.contended / t.acquisitions : 0.0)
+                << "%"
+                << std::setw(11) << std::setprecision(2) << t.wait_ticks / f * 1e-6
+                << " ms"
+                << std::setw(9) << std::setprecision(0) << percentile(t.wait, 0.5)
+                << " ns"
+                << std::setw(9) << percentile(t.wait, 0.99) << " ns"
+                << std::setw(9) << mean_hold << " ns"
+                << std::setw(9) << percentile(t.hold, 0.99) << " ns"
+                << std::endl;
+        }
+        out.unsetf(std::ios::fixed);
+        out << std::setprecision(6);
+    }
+}
+
+// the policy keeps the time stamps of one acquisition in the Lock
+// object and writes the counters after the mutex has been released
+template <typename Site>
+class Profiling {
+    private:
+        std::uint64_t acquired_ = 0;
+        std::uint64_t wait_ = 0;
+        bool contended_ = false;
+
+    public:
+        // an uncontended acquisition does not wait at all, so the
+        // clock is only read before the blocking call
+        template <typename T>
+        void lock(T& r) {
+            contended_ = !r.try_lock();
+            if (contended_) {
+                std::uint64_t start = profiling::ticks();
+                r.lock();
+                acquired_ = profiling::ticks();
+                wait_ = acquired_ - start;
+            } else {
+                acquired_ = profiling::ticks();
+                wait_ = 0;
+            }
+        }
+
+        template <typename T>
+        void locked(T&) {
+            acquired_ = profiling::ticks();
+            wait_ = 0;
+            contended_ = false;
+        }
+
+        template <typename T>
+        void unlock(T& r) {
+            std::uint64_t hold = profiling::ticks() - acquired_;
+            r.unlock();
+            profiling::ThreadCounters& c = profiling::thread_counters<Site>();
+            c.acquisitions.add(1);
+            c.contended.add(contended_ ? 1 : 0);
+            c.wait_ticks.add(wait_);
+            c.hold_ticks.add(hold);
+            c.wait[profiling::bucket(wait_)].add(1);
+            c.hold[profiling::bucket(hold)].add(1);
+        }
+};
+
+// ############ Example lock sites ##############
+struct routing_site {
+    static constexpr const char* name = "routing table";
+};
+
+struct stats_site {
+    static constexpr const char* name = "statistics";
+};
+
+struct config_site {
+    static constexpr const char* name = "config";
+};
+
+struct overhead_site {
+    static constexpr const char* name = "overhead test";
+};
+
+template <typename Guard>
+double lock_unlock(std::size_t iterations) {
+    std::mutex m;
+    long counter = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i=0; i<iterations; ++i) {
+        Guard guard(m);
+        ++counter;
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    return dt.count() * 1e9 / iterations;
+}
+
+
+int main() {
+    std::mutex routing;
+    std::mutex stats;
+    std::mutex config;
+    std::vector<double> table(1000, 1.0);
+    double total = 0.0;
+
+    // the routing table is held long and by all threads,
+    // the statistics are updated often but briefly
+    std::vector<std::thread> workers;
+    for (int t=0; t<4; ++t) {
+        workers.emplace_back([&]() {
+            for (int i=0; i<20000; ++i) {
+                {
+                    Lock<std::mutex, Profiling<routing_site>> lock(routing);
+                    for (double& x : table) {
+                        x *= 1.0000001;
+                    }
+                }
+                {
+                    Lock<std::mutex, Profiling<stats_site>> lock(stats);
+                    total += 1.0;
+                }
+                if (i % 100 == 0) {
+                    Lock<std::mutex, Profiling<config_site>> lock(config,
+                        std::try_to_lock);
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // the cost of profiling a single uncontended lock
+    double plain = lock_unlock<Lock<std::mutex>>(5000000);
+    double profiled = lock_unlock<Lock<std::mutex, Profiling<overhead_site>>>(5000000);
+    std::cout << "uncontended lock/unlock: " << plain << " ns, profiled: "
+        << profiled << " ns" << std::endl;
+
+    profiling::report(std::cout, 3);
+}
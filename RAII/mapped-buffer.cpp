@@ -0,0 +1,463 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    This is an extension of the file "memory-management.cpp", where
+    the resource managed by the class is a memory mapped file instead
+    of memory on the heap.
+
+    A data set that is kept in a Buffer has to be written to disk
+    and read back (deserialized) on every restart of the program.
+    With mmap the file itself becomes the memory of the buffer:
+    opening it only sets up the page table, and every page is read
+    from disk on the first access (lazily). A read-only mapping is
+    backed by the page cache, so several processes that map the same
+    file share the physical memory.
+
+    The file starts with a small header that stores a magic number,
+    a type tag, the size of one element, the number of elements and
+    the alignment of the data section. Opening a file checks the
+    header against the template parameters and throws a
+    std::runtime_error if they do not match.
+
+    MappedBuffer provides the same data()/size()/operator[] methods as
+    Buffer. MappedBuffer<const T> maps the file read-only and shared,
+    MappedBuffer<T> maps it writable, and changes are written back to
+    the file. Files are stored in native byte order.
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <chrono>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ############ Buffer class from memory-management.cpp ##############
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        size_t size() {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+template <typename T, std::size_t A>
+void init_buffer(Buffer<T, A>& b) {
+    for (size_t i=0; i<b.size(); ++i) {
+        b[i] = i+1;
+    }
+}
+
+// ############ File format ##############
+// type tags for the types that may be stored in a file;
+// the primary template is left undefined, so other types
+// fail to compile
+template <typename T>
+struct type_tag;
+
+template <> struct type_tag<std::int8_t>   { static constexpr std::uint32_t value = 1; };
+template <> struct type_tag<std::uint8_t>  { static constexpr std::uint32_t value = 2; };
+template <> struct type_tag<std::int16_t>  { static constexpr std::uint32_t value = 3; };
+template <> struct type_tag<std::uint16_t> { static constexpr std::uint32_t value = 4; };
+template <> struct type_tag<std::int32_t>  { static constexpr std::uint32_t value = 5; };
+template <> struct type_tag<std::uint32_t> { static constexpr std::uint32_t value = 6; };
+template <> struct type_tag<std::int64_t>  { static constexpr std::uint32_t value = 7; };
+template <> struct type_tag<std::uint64_t> { static constexpr std::uint32_t value = 8; };
+template <> struct type_tag<float>         { static constexpr std::uint32_t value = 9; };
+template <> struct type_tag<double>        { static constexpr std::uint32_t value = 10; };
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t type;
+    std::uint32_t element_size;
+    std::uint64_t count;
+    std::uint64_t alignment;
+    // offset of the first element from the start of the file
+    std::uint64_t offset;
+};
+
+constexpr char file_magic[8] = {'C', 'P', 'P', 'H', 'U', 'B', 'B', '1'};
+
+// the data section starts at a multiple of the alignment; as the
+// mapping itself starts at a page boundary, this carries over to
+// the memory address for all alignments up to the page size
+inline std::uint64_t data_offset(std::uint64_t alignment) {
+    return (sizeof(FileHeader) + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+FileHeader make_header(std::uint64_t count, std::uint64_t alignment) {
+    FileHeader h{};
+    std::memcpy(h.magic, file_magic, sizeof(file_magic));
+    h.type = type_tag<T>::value;
+    h.element_size = sizeof(T);
+    h.count = count;
+    h.alignment = alignment;
+    h.offset = data_offset(alignment);
+    return h;
+}
+
+// writes a buffer to a file with the regular write call
+template <typename T, std::size_t A>
+void save(Buffer<T, A>& b, const std::string& path) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("cannot create " + path);
+    }
+    FileHeader h = make_header<T>(b.size(), A);
+    bool ok = pwrite(fd, &h, sizeof(h), 0) == sizeof(h);
+    const char* p = reinterpret_cast<const char*>(b.data());
+    std::size_t left = b.size() * sizeof(T);
+    off_t pos = h.offset;
+    while (ok && left > 0) {
+        ssize_t w = pwrite(fd, p, left, pos);
+        ok = w > 0;
+        if (ok) {
+            p += w;
+            pos += w;
+            left -= w;
+        }
+    }
+    ::close(fd);
+    if (!ok) {
+        throw std::runtime_error("cannot write " + path);
+    }
+}
+
+// ############ MappedBuffer class ##############
+// T may be const qualified, in which case the file is
+// mapped read-only
+template <typename T, std::size_t Alignment = alignof(T)>
+class MappedBuffer {
+    using value_type = std::remove_const_t<T>;
+    static constexpr bool read_only = std::is_const<T>::value;
+
+    static_assert(std::is_trivially_copyable<value_type>::value,
+        "only trivially copyable types can be mapped");
+    static_assert((Alignment & (Alignment-1)) == 0 && Alignment <= 4096,
+        "Alignment must be a power of two up to the page size");
+
+    private:
+        std::size_t size_;
+        T* data_;
+        // the whole mapping including the header
+        void* base_;
+        std::size_t length_;
+
+        MappedBuffer(void* base, std::size_t length, std::size_t offset,
+            std::size_t count) :
+            size_(count),
+            data_(reinterpret_cast<T*>(static_cast<char*>(base) + offset)),
+            base_(base),
+            length_(length) {
+        }
+
+        static void* map(int fd, std::size_t length) {
+            int prot = read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            void* p = mmap(nullptr, length, prot, MAP_SHARED, fd, 0);
+            // the mapping keeps its own reference to the file
+            ::close(fd);
+            if (p == MAP_FAILED) {
+                throw std::runtime_error("mmap failed");
+            }
+            return p;
+        }
+
+    public:
+        // maps an existing file; nothing but the header is read
+        static MappedBuffer open(const std::string& path) {
+            int fd = ::open(path.c_str(), read_only ? O_RDONLY : O_RDWR);
+            if (fd < 0) {
+                throw std::runtime_error("cannot open " + path);
+            }
+            FileHeader h;
+            struct stat st;
+            if (pread(fd, &h, sizeof(h), 0) != sizeof(h)
+                || fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::runtime_error("cannot read header of " + path);
+            }
+            std::string error;
+            if (std::memcmp(h.magic, file_magic, sizeof(file_magic)) != 0) {
+                error = "not a buffer file: ";
+            } else if (h.type != type_tag<value_type>::value
+                || h.element_size != sizeof(value_type)) {
+                error = "element type does not match: ";
+            } else if (h.alignment < Alignment || h.offset % Alignment != 0) {
+                error = "alignment does not match: ";
+            } else if (h.offset + h.count * sizeof(value_type)
+                > static_cast<std::uint64_t>(st.st_size)) {
+                error = "file is truncated: ";
+            }
+            if (!error.empty()) {
+                ::close(fd);
+                throw std::runtime_error(error + path);
+            }
+            std::size_t length = h.offset + h.count * sizeof(value_type);
+            return MappedBuffer(map(fd, length), length, h.offset, h.count);
+        }
+
+        // creates a new file for count elements (all zero)
+        static MappedBuffer create(const std::string& path, std::size_t count) {
+            static_assert(!read_only, "cannot create a read-only buffer");
+            int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("cannot create " + path);
+            }
+            FileHeader h = make_header<value_type>(count, Alignment);
+            std::size_t length = h.offset + count * sizeof(value_type);
+            if (ftruncate(fd, length) != 0
+                || pwrite(fd, &h, sizeof(h), 0) != sizeof(h)) {
+                ::close(fd);
+                throw std::runtime_error("cannot write " + path);
+            }
+            return MappedBuffer(map(fd, length), length, h.offset, count);
+        }
+
+        ~MappedBuffer() {
+            if (base_ != nullptr) {
+                munmap(base_, length_);
+            }
+        }
+
+        MappedBuffer(MappedBuffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)),
+            base_(std::exchange(other.base_, nullptr)),
+            length_(std::exchange(other.length_, 0)) {
+        }
+
+        MappedBuffer& operator=(MappedBuffer&& other) noexcept {
+            if (this != &other) {
+                if (base_ != nullptr) {
+                    munmap(base_, length_);
+                }
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+                base_ = std::exchange(other.base_, nullptr);
+                length_ = std::exchange(other.length_, 0);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        size_t size() {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        // asks the kernel to read the whole file in the background,
+        // e.g. if it is clear that all of it will be needed soon
+        void prefetch() {
+            madvise(base_, length_, MADV_WILLNEED);
+        }
+
+        // writes changes back to disk now instead of
+        // at some time chosen by the kernel
+        void flush() {
+            static_assert(!read_only, "nothing to flush");
+            msync(base_, length_, MS_SYNC);
+        }
+
+        MappedBuffer(const MappedBuffer&) = delete;
+        MappedBuffer& operator=(const MappedBuffer&) = delete;
+};
+
+// the conventional way: read the whole file into a new buffer
+template <typename T>
+Buffer<T> load(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    FileHeader h;
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    if (pread(fd, &h, sizeof(h), 0) != sizeof(h)) {
+        ::close(fd);
+        throw std::runtime_error("cannot read " + path);
+    }
+    Buffer<T> b(h.count, uninitialized);
+    char* p = reinterpret_cast<char*>(b.data());
+    std::size_t left = h.count * sizeof(T);
+    off_t pos = h.offset;
+    while (left > 0) {
+        ssize_t r = pread(fd, p, left, pos);
+        if (r <= 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot read " + path);
+        }
+        p += r;
+        pos += r;
+        left -= r;
+    }
+    ::close(fd);
+    return b;
+}
+
+
+int main() {
+    const std::string path = "/tmp/cpphub-mapped-buffer.bin";
+    const std::size_t n = (std::size_t(256) << 20) / sizeof(double);
+
+    // write a data set once
+    {
+        Buffer<double, 64> b(n, uninitialized);
+        init_buffer(b);
+        save(b, path);
+    }
+
+    // restart with deserialization
+    auto start = std::chrono::steady_clock::now();
+    Buffer<double> loaded = load<double>(path);
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    std::cout << "load into Buffer: " << dt.count()*1e3 << " ms, b[12345] = "
+        << loaded[12345] << std::endl;
+
+    // restart with mmap: only the page table is set up here,
+    // the pages are read on first access
+    start = std::chrono::steady_clock::now();
+    auto mapped = MappedBuffer<const double, 64>::open(path);
+    dt = std::chrono::steady_clock::now() - start;
+    std::cout << "open MappedBuffer: " << dt.count()*1e3 << " ms, b[12345] = "
+        << mapped[12345] << std::endl;
+
+    // wrong types are detected by the header
+    try {
+        auto wrong = MappedBuffer<const float>::open(path);
+    } catch (const std::runtime_error& e) {
+        std::cout << "expected error: " << e.what() << std::endl;
+    }
+
+    // a child process maps the same file; both processes
+    // read the same physical pages from the page cache
+    pid_t pid = fork();
+    if (pid == 0) {
+        auto shared = MappedBuffer<const double, 64>::open(path);
+        std::cout << "child reads b[" << n-1 << "] = " << shared[n-1]
+            << std::endl;
+        _exit(0);
+    }
+    waitpid(pid, nullptr, 0);
+
+    // writable mapping, changes end up in the file
+    {
+        auto rw = MappedBuffer<double, 64>::open(path);
+        rw[0] = -1.0;
+        rw.flush();
+    }
+    std::cout << "read-only mapping sees the change: b[0] = " << mapped[0]
+        << std::endl;
+
+    unlink(path.c_str());
+}
@@ -36,65 +36,216 @@
 
     This file provides an example for memory management using the RAII
     principle for an elementary datatypes
+
+    The buffer can be moved but not copied: a move simply hands the
+    pointer over to the new owner and leaves the old object empty, so
+    buffers can be passed between functions without reallocation.
+    The second template parameter controls the alignment of the first
+    element, e.g. 32 bytes for AVX2 or 64 bytes for AVX-512 and cache
+    lines, such that aligned vector loads can be used on data().
+    For trivial types like int or double a buffer can also be created
+    without initializing its elements, which saves one full pass over
+    memory if the data is overwritten anyway.
+
+    begin() and end() return plain pointers, which are contiguous
+    iterators, so a Buffer can be used with range-based for loops,
+    all standard algorithms and std::span (c++20).
 */
 
 #include <iostream>
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <span>
+#include <numeric>
+#include <algorithm>
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// typical alignments in bytes
+constexpr std::size_t cacheline_alignment = 64;
+constexpr std::size_t avx2_alignment = 32;
+constexpr std::size_t avx512_alignment = 64;
 
-template <typename T>
+// tag type to select the constructor that leaves the
+// elements uninitialized (similar to std::defer_lock)
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+template <typename T, std::size_t Alignment = alignof(T)>
 class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
     private:
         std::size_t size_;
         T* data_;
 
+        // the aligned versions of operator new/delete (c++17)
+        // only return raw memory, elements are constructed
+        // separately
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
     public:
+        // types used by the standard library
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
         // Constructor takes the size argument and then allocates
         // memory using the new operator. The returned pointer
-        // is stored in a class attribute
-        Buffer(size_t s) : 
-            size_(s), 
-            data_(new T[size_]) {
+        // is stored in a class attribute. All elements are
+        // value initialized, i.e. set to zero for numbers
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                // the destructor is not called if the constructor
+                // throws, so we have to clean up here
+                release(data_);
+                throw;
+            }
+        }
+
+        // Same as above but the elements keep whatever is
+        // in memory; only allowed for types that need no
+        // constructor call
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
         }
 
-        // the destructor simply releases allocated memory
+        // the destructor destroys all elements and
+        // releases the allocated memory
         ~Buffer() {
-            // brackets are needed in order to free the array
-            // and not only the first element
-            delete[] data_;
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        // move constructor takes over the memory of other and
+        // leaves other empty, so that its destructor is harmless
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
         }
 
-        // add get methods
+        // move assignment releases the own memory first
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        // add get methods, the const versions make
+        // the buffer usable through a const reference
         T* data() {
             return data_;
         }
 
-        size_t size() {
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
             return size_;
         }
 
+        static constexpr std::size_t alignment() {
+            return Alignment;
+        }
 
         // now we will also overload the access operator
         // to make usage convenient and intuitive
         T& operator[] (size_t i) {
             return data_[i];
         }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        // iterators to the first and behind the last element
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        // a span is a non-owning view, it can be passed to functions
+        // that should not care about how the memory is managed
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
         
         // delete copy constructor and assignment operator
         // to prevent from usage with double free
         Buffer(const Buffer&) = delete;
-        Buffer(const Buffer&&) = delete;
         Buffer& operator=(const Buffer&) = delete;
-        Buffer& operator=(const Buffer&&) = delete;
 };
 
 // function to initialize such a buffer
-template <typename T>
-void init_buffer(Buffer<T>& b) {
+template <typename T, std::size_t A>
+void init_buffer(Buffer<T, A>& b) {
     for (size_t i=0; i<b.size(); ++i) {
         b[i] = i+1;
     }
 }
 
+// functions that take a span work with any contiguous memory
+double sum(std::span<const double> s) {
+    return std::accumulate(s.begin(), s.end(), 0.0);
+}
+
+// a pipeline stage that takes ownership of a buffer and
+// hands it on to the next stage without copying
+template <typename T, std::size_t A>
+Buffer<T, A> scale(Buffer<T, A> b, T factor) {
+    for (size_t i=0; i<b.size(); ++i) {
+        b[i] *= factor;
+    }
+    return b;
+}
+
 
 // add main function for demonstration
 int main() {
@@ -106,6 +257,11 @@ int main() {
     //Buffer<int> r(a);
     //r = a
 
+    // but we can move it, afterwards a is empty
+    Buffer<int> r(std::move(a));
+    std::cout << "size of a after move: " << a.size()
+        << ", size of r: " << r.size() << std::endl;
+
     // we can also control the life time of an object
     // by putting it to a dedicated block
     {
@@ -117,4 +273,30 @@ int main() {
         Buffer<float> c(100);
     } // destruction of c
 
-} // destruction of a
+    // buffer aligned for AVX-512 loads whose elements are
+    // not initialized as we write all of them in init_buffer
+    Buffer<float, avx512_alignment> d(1000, uninitialized);
+    init_buffer(d);
+    std::cout << "address of d is 64 byte aligned: " << std::boolalpha
+        << (reinterpret_cast<std::uintptr_t>(d.data()) % d.alignment() == 0)
+        << std::endl;
+
+    // hand d over to a stage and get it back, the memory is
+    // the same all the way through
+    float* before = d.data();
+    d = scale(std::move(d), 2.0f);
+    std::cout << "same memory after the stage: " << (d.data() == before)
+        << ", d[9] = " << d[9] << std::endl;
+
+    // the iterators are plain pointers
+    static_assert(std::contiguous_iterator<Buffer<double>::iterator>);
+    Buffer<double> e(5);
+    std::fill(e.begin(), e.end(), 1.5);
+    for (double& x : e) {
+        x *= 2.0;
+    }
+    std::cout << "sum of e: " << sum(e) << std::endl;
+
+} // destruction of e, d, r and a
+
+#endif // of #if __cplusplus < 201709L #else ...
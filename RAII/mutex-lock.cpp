@@ -37,15 +37,40 @@
     This file provides an example for usage of a mutex variable by the RAII
     principle. The standard library also provides a more sophisticated
     version as std::lock_guard in <mutex>.
+
+    The first version of the class (TracingLock) prints a message when
+    the resource is locked and unlocked. This is nice to watch, but it
+    is a bad idea in real code: the output happens while the mutex is
+    held, and std::cout with std::endl takes a global lock and flushes
+    with a system call. Every thread that waits for the mutex therefore
+    also waits for the terminal.
+    The second version (Lock) does no I/O at all and offers the same
+    features as std::unique_lock:
+        - deferred locking (std::defer_lock), try-locking
+          (std::try_to_lock) and taking over a mutex that is already
+          locked (std::adopt_lock)
+        - waiting for the mutex with a timeout (for std::timed_mutex)
+        - moving the ownership into another Lock, e.g. out of a function
+    Tracing can still be switched on with a policy class given as
+    second template parameter; the policy performs the actual locking
+    and unlocking, so it can keep its output (or any other work) out
+    of the critical section. The main function compares both versions with
+    std::lock_guard when several threads compete for the same mutex.
 */
 
 #include <mutex>
 #include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <system_error>
 
 // This class is designed to support all datatypes that
 // provide 'un-/lock' method, e.g. a mutex variable
 template <typename T>
-class Lock {
+class TracingLock {
     private:
         // resource is absolutely required to be caught
         // by reference
@@ -53,23 +78,272 @@ class Lock {
 
     public:
         // constructor locks the resource
-        Lock(T& r) : resource(r) {
+        TracingLock(T& r) : resource(r) {
             resource.lock();
             std::cout << "Resource is locked" << std::endl;
         }
 
         // destructor releases the resource
-        ~Lock() {
+        ~TracingLock() {
             resource.unlock();
             std::cout << "Resource is unlocked" << std::endl;
         }
 };
 
+// ############ Tracing policies ##############
+// A policy performs the locking and unlocking of the resource and
+// may record something around it:
+//     lock(r)    acquires r (blocking)
+//     unlock(r)  releases r
+//     locked(r)  r was acquired by try_lock, a timed lock or adopted
+// The Lock derives from its policy, so a policy may keep state per
+// Lock object, and an empty policy does not take any space.
+
+// the default policy does nothing else and is optimized away completely
+struct NoTracing {
+    template <typename T>
+    void lock(T& r) {
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+    }
+
+    template <typename T>
+    void locked(T&) {
+    }
+};
+
+// prints messages before locking and after unlocking,
+// i.e. outside of the critical section
+struct CoutTracing {
+    template <typename T>
+    void lock(T& r) {
+        std::cout << "Locking resource " << &r << std::endl;
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+        std::cout << "Resource " << &r << " is unlocked" << std::endl;
+    }
+
+    template <typename T>
+    void locked(T& r) {
+        std::cout << "Resource " << &r << " is locked" << std::endl;
+    }
+};
+
+// Lock without I/O; [[nodiscard]] at the constructors makes the
+// compiler warn about "Lock<std::mutex>{m};", which unlocks again
+// immediately (the attribute at the class covers functions that
+// return a Lock)
+template <typename T, typename Tracing = NoTracing>
+class [[nodiscard]] Lock : private Tracing {
+    private:
+        // a pointer instead of a reference, as a moved-from
+        // Lock does not refer to any resource
+        T* resource;
+        bool owns;
+
+    public:
+        // constructor locks the resource
+        [[nodiscard]] explicit Lock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        // only stores the resource, lock() is called later
+        Lock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        // does not block, check owns_lock() afterwards
+        [[nodiscard]] Lock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        // the resource is already locked by the calling thread
+        Lock(T& r, std::adopt_lock_t) : resource(&r), owns(true) {
+            Tracing::locked(*resource);
+        }
+
+        // waits at most for the given time (e.g. std::timed_mutex)
+        template <typename Rep, typename Period>
+        [[nodiscard]] Lock(T& r, const std::chrono::duration<Rep, Period>& timeout) :
+            resource(&r), owns(false) {
+            (void)try_lock_for(timeout);
+        }
+
+        // waits at most until the given point in time
+        template <typename Clock, typename Duration>
+        [[nodiscard]] Lock(T& r, const std::chrono::time_point<Clock, Duration>& deadline) :
+            resource(&r), owns(false) {
+            (void)try_lock_until(deadline);
+        }
+
+        // destructor releases the resource if it is owned
+        ~Lock() {
+            if (owns) {
+                unlock();
+            }
+        }
+
+        // the ownership can be passed on, but not copied
+        Lock(Lock&& other) noexcept :
+            Tracing(std::move(static_cast<Tracing&>(other))),
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        Lock& operator=(Lock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    unlock();
+                }
+                static_cast<Tracing&>(*this) = std::move(static_cast<Tracing&>(other));
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        // same errors as std::unique_lock
+        void lock() {
+            check();
+            Tracing::lock(*resource);
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock();
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+            check();
+            owns = resource->try_lock_for(timeout);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Clock, typename Duration>
+        [[nodiscard]] bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+            check();
+            owns = resource->try_lock_until(deadline);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            Tracing::unlock(*resource);
+        }
+
+        // gives up the ownership without unlocking
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// ############ Benchmark ##############
+// every thread increments a shared counter under the guard
+template <typename Guard>
+double contention(std::size_t threads, std::size_t iterations) {
+    std::mutex m;
+    long counter = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t<threads; ++t) {
+        workers.emplace_back([&m, &counter, iterations]() {
+            for (std::size_t i=0; i<iterations; ++i) {
+                Guard guard(m);
+                ++counter;
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    if (counter != static_cast<long>(threads * iterations)) {
+        std::cout << "wrong count" << std::endl;
+    }
+    return dt.count() * 1e9 / (threads * iterations);
+}
+
 int main() {
     std::cout << "Start of script" << std::endl;
     std::mutex m;
     {
-        Lock<std::mutex> lock(m);
+        TracingLock<std::mutex> lock(m);
+    }
+
+    // the new version, with tracing switched on
+    {
+        Lock<std::mutex, CoutTracing> lock(m);
+    }
+
+    // deferred locking and moving the ownership
+    {
+        Lock<std::mutex> lock(m, std::defer_lock);
+        lock.lock();
+        Lock<std::mutex> other(std::move(lock));
+        std::cout << "moved lock owns: " << other.owns_lock()
+            << ", old lock owns: " << lock.owns_lock() << std::endl;
+    }
+
+    // waiting with timeout
+    {
+        std::timed_mutex tm;
+        Lock<std::timed_mutex> first(tm);
+        std::thread([&tm]() {
+            Lock<std::timed_mutex> second(tm, std::chrono::milliseconds(10));
+            std::cout << "second lock after timeout owns: "
+                << second.owns_lock() << std::endl;
+        }).join();
     }
 
     // Repeat the procedure with the STL lock_guard
@@ -77,6 +351,19 @@ int main() {
         std::lock_guard<std::mutex> lock(m);
     }
 
+    // the old version writes to std::cout; for the benchmark
+    // the output is sent to /dev/null (still flushed every time)
+    std::cout << "ns per lock/unlock:" << std::endl;
+    std::ofstream null("/dev/null");
+    for (std::size_t threads : {1, 2, 4, 8}) {
+        auto* old = std::cout.rdbuf(null.rdbuf());
+        double tracing = contention<TracingLock<std::mutex>>(threads, 20000);
+        std::cout.rdbuf(old);
+        double lock = contention<Lock<std::mutex>>(threads, 1000000);
+        double guard = contention<std::lock_guard<std::mutex>>(threads, 1000000);
+        std::cout << "    " << threads << " thread(s): TracingLock " << tracing
+            << ", Lock " << lock << ", std::lock_guard " << guard << std::endl;
+    }
 
     std::cout << "End of script" << std::endl;
 }
@@ -0,0 +1,711 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    Data like configurations or routing tables is read very often and
+    written rarely. The exclusive Lock of "mutex-lock.cpp" lets only
+    one reader in at a time, although readers could run in parallel.
+    This file adds:
+        - SharedLock: the RAII guard for shared (reader) ownership,
+          the counterpart of Lock for lock_shared()/unlock_shared()
+          (as std::shared_lock)
+        - DistributedRwLock: a reader-writer lock with one reader
+          counter per cache line. std::shared_mutex keeps all readers
+          in a single counter, so every reader writes to the same
+          cache line and the readers do not scale with the number
+          of cores, even though they never wait for each other.
+          Writers have to check all counters, which makes writing
+          more expensive.
+        - Seqlock: readers do not write anything at all. They read
+          optimistically and retry if a writer was active in the
+          meantime. Only for trivially copyable data, as a reader
+          may see a torn copy (which is then discarded).
+
+    The main function runs readers on all cores against one writer
+    and prints the reads per second.
+*/
+
+#include <mutex>
+#include <shared_mutex>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <system_error>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// ############ Tracing policies ##############
+// A policy performs the locking and unlocking of the resource and
+// may record something around it:
+//     lock(r)    acquires r (blocking)
+//     unlock(r)  releases r
+//     locked(r)  r was acquired by try_lock, a timed lock or adopted
+// The Lock derives from its policy, so a policy may keep state per
+// Lock object, and an empty policy does not take any space.
+
+// the default policy does nothing else and is optimized away completely
+struct NoTracing {
+    template <typename T>
+    void lock(T& r) {
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+    }
+
+    template <typename T>
+    void locked(T&) {
+    }
+};
+
+
+// Lock without I/O; [[nodiscard]] at the constructors makes the
+// compiler warn about "Lock<std::mutex>{m};", which unlocks again
+// immediately (the attribute at the class covers functions that
+// return a Lock)
+template <typename T, typename Tracing = NoTracing>
+class [[nodiscard]] Lock : private Tracing {
+    private:
+        // a pointer instead of a reference, as a moved-from
+        // Lock does not refer to any resource
+        T* resource;
+        bool owns;
+
+    public:
+        // constructor locks the resource
+        [[nodiscard]] explicit Lock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        // only stores the resource, lock() is called later
+        Lock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        // does not block, check owns_lock() afterwards
+        [[nodiscard]] Lock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        // the resource is already locked by the calling thread
+        Lock(T& r, std::adopt_lock_t) : resource(&r), owns(true) {
+            Tracing::locked(*resource);
+        }
+
+        // waits at most for the given time (e.g. std::timed_mutex)
+        template <typename Rep, typename Period>
+        [[nodiscard]] Lock(T& r, const std::chrono::duration<Rep, Period>& timeout) :
+            resource(&r), owns(false) {
+            (void)try_lock_for(timeout);
+        }
+
+        // waits at most until the given point in time
+        template <typename Clock, typename Duration>
+        [[nodiscard]] Lock(T& r, const std::chrono::time_point<Clock, Duration>& deadline) :
+            resource(&r), owns(false) {
+            (void)try_lock_until(deadline);
+        }
+
+        // destructor releases the resource if it is owned
+        ~Lock() {
+            if (owns) {
+                unlock();
+            }
+        }
+
+        // the ownership can be passed on, but not copied
+        Lock(Lock&& other) noexcept :
+            Tracing(std::move(static_cast<Tracing&>(other))),
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        Lock& operator=(Lock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    unlock();
+                }
+                static_cast<Tracing&>(*this) = std::move(static_cast<Tracing&>(other));
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        // same errors as std::unique_lock
+        void lock() {
+            check();
+            Tracing::lock(*resource);
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock();
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+            check();
+            owns = resource->try_lock_for(timeout);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Clock, typename Duration>
+        [[nodiscard]] bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+            check();
+            owns = resource->try_lock_until(deadline);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            Tracing::unlock(*resource);
+        }
+
+        // gives up the ownership without unlocking
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// guard for shared ownership; same interface and errors as Lock
+template <typename T>
+class [[nodiscard]] SharedLock {
+    private:
+        T* resource;
+        bool owns;
+
+    public:
+        [[nodiscard]] explicit SharedLock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        SharedLock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        [[nodiscard]] SharedLock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        SharedLock(T& r, std::adopt_lock_t) noexcept : resource(&r), owns(true) {
+        }
+
+        ~SharedLock() {
+            if (owns) {
+                resource->unlock_shared();
+            }
+        }
+
+        SharedLock(SharedLock&& other) noexcept :
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        SharedLock& operator=(SharedLock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    resource->unlock_shared();
+                }
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        SharedLock(const SharedLock&) = delete;
+        SharedLock& operator=(const SharedLock&) = delete;
+
+        void lock() {
+            check();
+            resource->lock_shared();
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock_shared();
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            resource->unlock_shared();
+        }
+
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// ############ Lock types ##############
+constexpr std::size_t cacheline_size = 64;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Reader-writer lock with distributed reader counters. Every thread
+// gets one of the slots (round robin on first use) and only writes
+// to the counter of its slot. With at most reader_slots threads no
+// two readers share a cache line.
+// A reader increments its counter and then checks the writer flag, a
+// writer sets the flag and then checks all counters. With sequentially
+// consistent operations at least one of them sees the other, so both
+// can never get in together. Readers step back while a writer waits,
+// so writers cannot starve.
+class DistributedRwLock {
+    private:
+        static constexpr std::size_t reader_slots = 64;
+
+        struct alignas(cacheline_size) Slot {
+            std::atomic<std::uint32_t> readers{0};
+        };
+
+        Slot slots[reader_slots];
+        alignas(cacheline_size) std::atomic<bool> writer{false};
+        // serializes the writers
+        std::mutex writers;
+
+        static std::size_t my_slot() {
+            static std::atomic<std::size_t> next{0};
+            thread_local std::size_t slot =
+                next.fetch_add(1, std::memory_order_relaxed) % reader_slots;
+            return slot;
+        }
+
+        // waits until all readers have left; the loads have to be
+        // sequentially consistent as well, acquire loads may see an
+        // old 0 from a reader that has already seen writer == false
+        void wait_for_readers() {
+            for (Slot& s : slots) {
+                unsigned rounds = 0;
+                while (s.readers.load(std::memory_order_seq_cst) != 0) {
+                    if (++rounds < 64) {
+                        cpu_relax();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        bool no_readers() const {
+            for (const Slot& s : slots) {
+                if (s.readers.load(std::memory_order_seq_cst) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    public:
+        void lock() {
+            writers.lock();
+            writer.store(true, std::memory_order_seq_cst);
+            wait_for_readers();
+        }
+
+        bool try_lock() {
+            if (!writers.try_lock()) {
+                return false;
+            }
+            writer.store(true, std::memory_order_seq_cst);
+            if (!no_readers()) {
+                writer.store(false, std::memory_order_release);
+                writer.notify_all();
+                writers.unlock();
+                return false;
+            }
+            return true;
+        }
+
+        void unlock() {
+            writer.store(false, std::memory_order_release);
+            writer.notify_all();
+            writers.unlock();
+        }
+
+        void lock_shared() {
+            std::atomic<std::uint32_t>& readers = slots[my_slot()].readers;
+            for (;;) {
+                readers.fetch_add(1, std::memory_order_seq_cst);
+                if (!writer.load(std::memory_order_seq_cst)) {
+                    return;
+                }
+                // step back and sleep until the writer is done
+                readers.fetch_sub(1, std::memory_order_release);
+                writer.wait(true, std::memory_order_acquire);
+            }
+        }
+
+        bool try_lock_shared() {
+            std::atomic<std::uint32_t>& readers = slots[my_slot()].readers;
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            if (!writer.load(std::memory_order_seq_cst)) {
+                return true;
+            }
+            readers.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+
+        void unlock_shared() {
+            slots[my_slot()].readers.fetch_sub(1, std::memory_order_release);
+        }
+};
+
+// Sequence lock: the sequence number is odd while a write is in
+// progress. A reader copies the data and accepts the copy only if
+// the sequence number was even and unchanged.
+// The data is kept in relaxed atomic words, so a concurrent read of a
+// half-written value is a valid (discarded) result and not a data race.
+template <typename T>
+requires std::is_trivially_copyable<T>::value
+class Seqlock {
+    private:
+        static constexpr std::size_t word_count =
+            (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        alignas(cacheline_size) std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::uint64_t> words[word_count];
+        // serializes the writers
+        std::mutex writers;
+
+        // copies the words without any ordering; the fences
+        // around it are placed by the callers
+        void read_words(T& out) const {
+            std::uint64_t buffer[word_count];
+            for (std::size_t i=0; i<word_count; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::memcpy(&out, buffer, sizeof(T));
+        }
+
+        void write_words(const T& value) {
+            std::uint64_t buffer[word_count] = {};
+            std::memcpy(buffer, &value, sizeof(T));
+            for (std::size_t i=0; i<word_count; ++i) {
+                words[i].store(buffer[i], std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        explicit Seqlock(const T& value = T{}) {
+            write_words(value);
+        }
+
+        Seqlock(const Seqlock&) = delete;
+        Seqlock& operator=(const Seqlock&) = delete;
+
+        // one optimistic attempt; false if a writer interfered,
+        // out is unspecified then
+        [[nodiscard]] bool try_load(T& out) const {
+            std::uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                return false;
+            }
+            read_words(out);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return sequence.load(std::memory_order_relaxed) == before;
+        }
+
+        // retries until a consistent copy was read
+        T load() const {
+            T out;
+            unsigned rounds = 0;
+            while (!try_load(out)) {
+                if (++rounds < 64) {
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            return out;
+        }
+
+        void store(const T& value) {
+            update([&value](T& v) { v = value; });
+        }
+
+        // read-modify-write under the writer lock: f gets a copy
+        // of the current value and may modify it
+        template <typename F>
+        void update(F f) {
+            Lock<std::mutex> lock(writers);
+            T value;
+            read_words(value);
+            f(value);
+            std::uint64_t s = sequence.load(std::memory_order_relaxed);
+            sequence.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            write_words(value);
+            sequence.store(s + 2, std::memory_order_release);
+        }
+};
+
+// ############ Benchmark ##############
+// a small routing table as read-mostly data
+struct Routes {
+    std::uint64_t next_hop[8];
+};
+
+std::uint64_t route_sum(const Routes& r) {
+    std::uint64_t sum = 0;
+    for (std::uint64_t h : r.next_hop) {
+        sum += h;
+    }
+    return sum;
+}
+
+// the three ways to protect the routes, all with the same interface
+template <typename Mutex>
+class Guarded {
+    private:
+        mutable Mutex m;
+        Routes routes{};
+
+    public:
+        std::uint64_t read() const {
+            SharedLock<Mutex> lock(m);
+            return route_sum(routes);
+        }
+
+        void write(std::uint64_t v) {
+            Lock<Mutex> lock(m);
+            for (std::uint64_t& h : routes.next_hop) {
+                h = v;
+            }
+        }
+};
+
+// std::mutex has no shared mode, the readers take it exclusively
+template <>
+std::uint64_t Guarded<std::mutex>::read() const {
+    Lock<std::mutex> lock(m);
+    return route_sum(routes);
+}
+
+class Sequenced {
+    private:
+        Seqlock<Routes> routes;
+
+    public:
+        std::uint64_t read() const {
+            return route_sum(routes.load());
+        }
+
+        void write(std::uint64_t v) {
+            routes.update([v](Routes& r) {
+                for (std::uint64_t& h : r.next_hop) {
+                    h = v;
+                }
+            });
+        }
+};
+
+// readers read as often as they can for a fixed time, a writer
+// updates the routes every writer_period; returns million reads per second
+template <typename Table>
+double run(std::size_t readers, std::chrono::microseconds writer_period) {
+    using namespace std::chrono_literals;
+    constexpr auto duration = 200ms;
+    Table table;
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> reads{0};
+    std::atomic<bool> torn{false};
+
+    std::vector<std::thread> threads;
+    for (std::size_t t=0; t<readers; ++t) {
+        threads.emplace_back([&]() {
+            std::uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                // all next hops are written together, so the sum
+                // of a consistent read is a multiple of 8
+                if (table.read() % 8 != 0) {
+                    torn.store(true, std::memory_order_relaxed);
+                }
+                ++n;
+            }
+            reads.fetch_add(n, std::memory_order_relaxed);
+        });
+    }
+    threads.emplace_back([&]() {
+        std::uint64_t v = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            table.write(++v);
+            std::this_thread::sleep_for(writer_period);
+        }
+    });
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (torn.load()) {
+        std::cout << "inconsistent read!" << std::endl;
+    }
+    std::chrono::duration<double> seconds = duration;
+    return reads.load() / seconds.count() / 1e6;
+}
+
+
+int main() {
+    using namespace std::chrono_literals;
+
+    // the guards with std::shared_mutex
+    std::shared_mutex m;
+    {
+        SharedLock<std::shared_mutex> r1(m);
+        SharedLock<std::shared_mutex> r2(m);
+        Lock<std::shared_mutex> w(m, std::try_to_lock);
+        std::cout << "writer gets in while readers hold the lock: "
+            << w.owns_lock() << std::endl;
+    }
+
+    // optimistic reads of the seqlock
+    Seqlock<Routes> seq;
+    seq.store(Routes{{1, 2, 3, 4, 5, 6, 7, 8}});
+    Routes r;
+    if (seq.try_load(r)) {
+        std::cout << "seqlock read: " << route_sum(r) << std::endl;
+    }
+
+    std::size_t max_readers = std::thread::hardware_concurrency();
+    if (max_readers < 1) {
+        max_readers = 1;
+    }
+    std::vector<std::size_t> reader_counts;
+    for (std::size_t readers=1; readers<max_readers; readers*=2) {
+        reader_counts.push_back(readers);
+    }
+    reader_counts.push_back(max_readers);
+
+    std::cout << "million reads per second, one write every 100 us ("
+        << std::thread::hardware_concurrency() << " cores)" << std::endl;
+    std::cout << std::setw(8) << "readers" << std::setw(12) << "std::mutex"
+        << std::setw(19) << "std::shared_mutex" << std::setw(19) << "DistributedRwLock"
+        << std::setw(10) << "Seqlock" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (std::size_t readers : reader_counts) {
+        std::cout << std::setw(8) << readers
+            << std::setw(12) << run<Guarded<std::mutex>>(readers, 100us)
+            << std::setw(19) << run<Guarded<std::shared_mutex>>(readers, 100us)
+            << std::setw(19) << run<Guarded<DistributedRwLock>>(readers, 100us)
+            << std::setw(10) << run<Sequenced>(readers, 100us)
+            << std::endl;
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
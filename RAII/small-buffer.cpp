@@ -0,0 +1,329 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    This is an extension of the file "memory-management.cpp" with
+    the small buffer optimization (also used by std::string and
+    llvm::SmallVector).
+
+    The Buffer of memory-management.cpp (move-only, with an alignment
+    parameter, an uninitialized constructor, contiguous iterators and
+    span conversions) gets a third template parameter N: up to N
+    elements are stored inside the object itself, only larger buffers
+    allocate memory on the heap. For small sizes this saves the
+    allocation and the deallocation, and the elements sit right next
+    to the size and pointer members, i.e. usually in the same cache
+    line. With N = 0 (the default) every buffer is on the heap, and
+    Buffer<T, Alignment> means the same as in memory-management.cpp.
+
+    The data_ pointer points either to the inline storage or to the
+    heap, so operator[] needs no branch. The price is that a move of
+    an inline buffer has to move the elements one by one (a heap
+    buffer is still moved by passing on the pointer).
+    Also, every object occupies the space of N elements, whether it
+    uses them or not. In a container of buffers that are much smaller
+    than N this wastes cache space, so N should be chosen close to
+    the typical size (compare the access benchmark for 4 elements).
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <span>
+#include <chrono>
+#include <vector>
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// tag type to select the constructor that leaves the
+// elements uninitialized (similar to std::defer_lock)
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+template <typename T, std::size_t Alignment = alignof(T), std::size_t N = 0>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+        // raw memory for N elements; the elements are constructed
+        // by the constructor, just like on the heap. Without inline
+        // elements the array does not need the alignment either
+        alignas(N > 0 ? Alignment : 1) unsigned char inline_[N > 0 ? N*sizeof(T) : 1];
+
+        T* inline_data() {
+            return reinterpret_cast<T*>(inline_);
+        }
+
+        bool is_inline() const {
+            return size_ <= N;
+        }
+
+        // only allocates if the elements do not fit inline
+        T* allocate(std::size_t n) {
+            if (n <= N) {
+                return inline_data();
+            }
+            return static_cast<T*>(::operator new(n*sizeof(T),
+                std::align_val_t(Alignment)));
+        }
+
+        void deallocate() {
+            if (!is_inline()) {
+                ::operator delete(data_, std::align_val_t(Alignment));
+            }
+        }
+
+        void release() {
+            std::destroy_n(data_, size_);
+            deallocate();
+        }
+
+        // takes over the elements of other and leaves it empty
+        void steal(Buffer& other) {
+            if (other.is_inline()) {
+                data_ = inline_data();
+                std::uninitialized_move_n(other.data_, other.size_, data_);
+                std::destroy_n(other.data_, other.size_);
+            } else {
+                data_ = other.data_;
+            }
+            size_ = other.size_;
+            other.size_ = 0;
+            other.data_ = other.inline_data();
+        }
+
+    public:
+        // types used by the standard library
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        // all elements are value initialized
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(s)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                deallocate();
+                throw;
+            }
+        }
+
+        // the elements keep whatever is in memory
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(s)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            release();
+        }
+
+        // moving an inline buffer may throw if moving T does
+        Buffer(Buffer&& other) noexcept(std::is_nothrow_move_constructible<T>::value || N == 0) :
+            size_(0),
+            data_(inline_data()) {
+            steal(other);
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept(std::is_nothrow_move_constructible<T>::value || N == 0) {
+            if (this != &other) {
+                release();
+                size_ = 0;
+                data_ = inline_data();
+                steal(other);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        static constexpr std::size_t alignment() {
+            return Alignment;
+        }
+
+        static constexpr std::size_t inline_capacity() {
+            return N;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+template <typename T, std::size_t A, std::size_t N>
+void init_buffer(Buffer<T, A, N>& b) {
+    for (size_t i=0; i<b.size(); ++i) {
+        b[i] = i+1;
+    }
+}
+
+// ############ Benchmarks ##############
+// creates, fills and destroys one buffer per iteration
+template <std::size_t N>
+double construction(std::size_t size, std::size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    long sum = 0;
+    for (std::size_t it=0; it<iterations; ++it) {
+        Buffer<int, alignof(int), N> b(size);
+        init_buffer(b);
+        sum += b[size-1];
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    volatile long sink = sum;
+    (void)sink;
+    return dt.count() * 1e9 / iterations;
+}
+
+// sums up all elements of many buffers, i.e. the typical access
+// pattern when buffers are kept in a container
+template <std::size_t N>
+double access(std::size_t size, std::size_t count, std::size_t repetitions) {
+    std::vector<Buffer<int, alignof(int), N>> buffers;
+    buffers.reserve(count);
+    for (std::size_t i=0; i<count; ++i) {
+        buffers.emplace_back(size);
+        init_buffer(buffers.back());
+    }
+    auto start = std::chrono::steady_clock::now();
+    long sum = 0;
+    for (std::size_t r=0; r<repetitions; ++r) {
+        for (auto& b : buffers) {
+            for (std::size_t i=0; i<b.size(); ++i) {
+                sum += b[i];
+            }
+        }
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    volatile long sink = sum;
+    (void)sink;
+    return dt.count() * 1e9 / (repetitions * count * size);
+}
+
+
+int main() {
+    // fits inline, no heap allocation
+    Buffer<double, alignof(double), 16> a(10);
+    init_buffer(a);
+    // too large, goes to the heap
+    Buffer<double, alignof(double), 16> b(100);
+    init_buffer(b);
+
+    // moving an inline buffer moves its elements
+    Buffer<double, alignof(double), 16> c(std::move(a));
+    std::cout << "c[9] = " << c[9] << ", a is empty: " << (a.size() == 0)
+        << std::endl;
+
+    // inline storage aligned for AVX-512, elements left uninitialized;
+    // the buffer is still a contiguous range
+    Buffer<float, 64, 32> d(32, uninitialized);
+    init_buffer(d);
+    float total = 0.0f;
+    for (float x : std::span<const float>(d)) {
+        total += x;
+    }
+    std::cout << "d is 64 byte aligned: " << std::boolalpha
+        << (reinterpret_cast<std::uintptr_t>(d.data()) % d.alignment() == 0)
+        << ", sum of d: " << total << std::endl;
+
+    std::cout << "construction + init + destruction (ns per buffer):"
+        << std::endl;
+    for (std::size_t size : {4, 16, 48, 64, 1000}) {
+        double heap = construction<0>(size, 2000000);
+        double small = construction<64>(size, 2000000);
+        std::cout << "    " << size << " elements: heap " << heap
+            << ", inline capacity 64: " << small << std::endl;
+    }
+
+    std::cout << "summing 100000 buffers (ns per element):" << std::endl;
+    for (std::size_t size : {4, 16, 48, 64, 1000}) {
+        std::size_t count = size < 1000 ? 100000 : 10000;
+        double heap = access<0>(size, count, 20);
+        double small = access<64>(size, count, 20);
+        std::cout << "    " << size << " elements: heap " << heap
+            << ", inline capacity 64: " << small << std::endl;
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
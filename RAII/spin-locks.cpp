@@ -0,0 +1,581 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    The Lock class of "mutex-lock.cpp" works with every type that
+    provides lock() and unlock() (and try_lock() for the try
+    variants). This file adds a few such types for very short
+    critical sections, where the system call of a sleeping mutex
+    costs more than the critical section itself:
+        - SpinLock: test-and-test-and-set; waiting threads only read
+          the flag (which stays in their cache) and back off
+          exponentially with the pause instruction in between
+        - TicketLock: every thread draws a ticket and waits until it
+          is served, so the lock is granted in FIFO order (fair)
+        - McsLock: every waiting thread spins on a flag in its own
+          queue node, so a release only touches the cache line of
+          the next thread in the queue (scales to many cores)
+        - AdaptiveMutex: spins for a short while and then sleeps
+          (futex via c++20 std::atomic::wait), like a pthread mutex
+          with PTHREAD_MUTEX_ADAPTIVE_NP
+
+    Spinning is only useful if the lock holder is running on another
+    core at the same time. With more threads than cores the holder
+    may be preempted, and a spinning thread would burn its time slice
+    for nothing. The pure spin locks therefore yield the cpu after
+    a while; the AdaptiveMutex goes to sleep. The fair locks suffer
+    most: the lock can only be handed to one particular thread, and
+    if that one is not running, all others have to wait as well.
+
+    The main function runs a matrix of thread counts (up to the
+    number of cores) and lengths of the critical section against
+    std::mutex.
+*/
+
+#include <mutex>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// ############ Tracing policies ##############
+// A policy performs the locking and unlocking of the resource and
+// may record something around it:
+//     lock(r)    acquires r (blocking)
+//     unlock(r)  releases r
+//     locked(r)  r was acquired by try_lock, a timed lock or adopted
+// The Lock derives from its policy, so a policy may keep state per
+// Lock object, and an empty policy does not take any space.
+
+// the default policy does nothing else and is optimized away completely
+struct NoTracing {
+    template <typename T>
+    void lock(T& r) {
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+    }
+
+    template <typename T>
+    void locked(T&) {
+    }
+};
+
+
+// Lock without I/O; [[nodiscard]] at the constructors makes the
+// compiler warn about "Lock<std::mutex>{m};", which unlocks again
+// immediately (the attribute at the class covers functions that
+// return a Lock)
+template <typename T, typename Tracing = NoTracing>
+class [[nodiscard]] Lock : private Tracing {
+    private:
+        // a pointer instead of a reference, as a moved-from
+        // Lock does not refer to any resource
+        T* resource;
+        bool owns;
+
+    public:
+        // constructor locks the resource
+        [[nodiscard]] explicit Lock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        // only stores the resource, lock() is called later
+        Lock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        // does not block, check owns_lock() afterwards
+        [[nodiscard]] Lock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        // the resource is already locked by the calling thread
+        Lock(T& r, std::adopt_lock_t) : resource(&r), owns(true) {
+            Tracing::locked(*resource);
+        }
+
+        // waits at most for the given time (e.g. std::timed_mutex)
+        template <typename Rep, typename Period>
+        [[nodiscard]] Lock(T& r, const std::chrono::duration<Rep, Period>& timeout) :
+            resource(&r), owns(false) {
+            (void)try_lock_for(timeout);
+        }
+
+        // waits at most until the given point in time
+        template <typename Clock, typename Duration>
+        [[nodiscard]] Lock(T& r, const std::chrono::time_point<Clock, Duration>& deadline) :
+            resource(&r), owns(false) {
+            (void)try_lock_until(deadline);
+        }
+
+        // destructor releases the resource if it is owned
+        ~Lock() {
+            if (owns) {
+                unlock();
+            }
+        }
+
+        // the ownership can be passed on, but not copied
+        Lock(Lock&& other) noexcept :
+            Tracing(std::move(static_cast<Tracing&>(other))),
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        Lock& operator=(Lock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    unlock();
+                }
+                static_cast<Tracing&>(*this) = std::move(static_cast<Tracing&>(other));
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        // same errors as std::unique_lock
+        void lock() {
+            check();
+            Tracing::lock(*resource);
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock();
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+            check();
+            owns = resource->try_lock_for(timeout);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Clock, typename Duration>
+        [[nodiscard]] bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+            check();
+            owns = resource->try_lock_until(deadline);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            Tracing::unlock(*resource);
+        }
+
+        // gives up the ownership without unlocking
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// ############ Lock types ##############
+constexpr std::size_t cacheline_size = 64;
+
+// tells the cpu that we are in a spin loop; on x86 this saves
+// power and avoids a pipeline flush when the loop exits
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// spins with exponential backoff; after max_rounds rounds
+// the thread gives up its time slice in every round
+class Backoff {
+    private:
+        static constexpr unsigned max_delay = 1024;
+        static constexpr unsigned max_rounds = 16;
+        unsigned delay = 1;
+        unsigned rounds = 0;
+
+    public:
+        void pause() {
+            if (rounds < max_rounds) {
+                for (unsigned i=0; i<delay; ++i) {
+                    cpu_relax();
+                }
+                delay = delay < max_delay ? 2*delay : max_delay;
+                ++rounds;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+};
+
+// test-and-test-and-set spin lock
+class SpinLock {
+    private:
+        alignas(cacheline_size) std::atomic<bool> locked{false};
+
+    public:
+        void lock() {
+            // the exchange writes to the cache line, so it is only
+            // tried if a plain read shows that the lock is free
+            while (locked.exchange(true, std::memory_order_acquire)) {
+                Backoff backoff;
+                while (locked.load(std::memory_order_relaxed)) {
+                    backoff.pause();
+                }
+            }
+        }
+
+        bool try_lock() {
+            return !locked.load(std::memory_order_relaxed)
+                && !locked.exchange(true, std::memory_order_acquire);
+        }
+
+        void unlock() {
+            locked.store(false, std::memory_order_release);
+        }
+};
+
+// FIFO lock: next is the next ticket to draw,
+// serving is the ticket that may enter
+class TicketLock {
+    private:
+        alignas(cacheline_size) std::atomic<std::uint32_t> next{0};
+        std::atomic<std::uint32_t> serving{0};
+
+    public:
+        void lock() {
+            const std::uint32_t ticket = next.fetch_add(1, std::memory_order_relaxed);
+            unsigned rounds = 0;
+            for (;;) {
+                std::uint32_t now = serving.load(std::memory_order_acquire);
+                if (now == ticket) {
+                    return;
+                }
+                // the waiting time is roughly proportional
+                // to the number of threads ahead of us
+                if (++rounds < 64) {
+                    for (std::uint32_t i=0; i<32*(ticket-now); ++i) {
+                        cpu_relax();
+                    }
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        bool try_lock() {
+            std::uint32_t now = serving.load(std::memory_order_relaxed);
+            std::uint32_t expected = now;
+            return next.compare_exchange_strong(expected, now + 1,
+                std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        // only the owner writes serving, so a plain
+        // increment suffices
+        void unlock() {
+            serving.store(serving.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+        }
+};
+
+// MCS queue lock (Mellor-Crummey and Scott). The lock itself is only
+// a pointer to the last node of the queue. The nodes come from a small
+// per-thread pool, so lock() and unlock() need no extra argument and
+// the class can be used with Lock<T>.
+class McsLock {
+    private:
+        struct alignas(cacheline_size) Node {
+            std::atomic<Node*> next{nullptr};
+            std::atomic<bool> waiting{false};
+            // link in the free list of the pool
+            Node* free = nullptr;
+        };
+
+        // nodes are reused in LIFO order and freed on thread exit
+        struct Pool {
+            Node* head = nullptr;
+
+            ~Pool() {
+                while (head != nullptr) {
+                    delete std::exchange(head, head->free);
+                }
+            }
+
+            Node* get() {
+                if (head == nullptr) {
+                    return new Node;
+                }
+                return std::exchange(head, head->free);
+            }
+
+            void put(Node* n) {
+                n->free = head;
+                head = n;
+            }
+        };
+
+        static Pool& pool() {
+            thread_local Pool p;
+            return p;
+        }
+
+        alignas(cacheline_size) std::atomic<Node*> tail{nullptr};
+        // node of the current owner, only used by the owner
+        Node* owner = nullptr;
+
+    public:
+        void lock() {
+            Node* me = pool().get();
+            me->next.store(nullptr, std::memory_order_relaxed);
+            me->waiting.store(true, std::memory_order_relaxed);
+            Node* prev = tail.exchange(me, std::memory_order_acq_rel);
+            if (prev != nullptr) {
+                // enqueue behind prev and wait for its hand-over
+                prev->next.store(me, std::memory_order_release);
+                Backoff backoff;
+                while (me->waiting.load(std::memory_order_acquire)) {
+                    backoff.pause();
+                }
+            }
+            owner = me;
+        }
+
+        bool try_lock() {
+            Node* me = pool().get();
+            me->next.store(nullptr, std::memory_order_relaxed);
+            Node* expected = nullptr;
+            if (tail.compare_exchange_strong(expected, me,
+                std::memory_order_acquire, std::memory_order_relaxed)) {
+                owner = me;
+                return true;
+            }
+            pool().put(me);
+            return false;
+        }
+
+        void unlock() {
+            Node* me = owner;
+            Node* next = me->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                // no successor known: try to empty the queue
+                Node* expected = me;
+                if (tail.compare_exchange_strong(expected, nullptr,
+                    std::memory_order_release, std::memory_order_relaxed)) {
+                    pool().put(me);
+                    return;
+                }
+                // a successor is just enqueuing itself
+                while ((next = me->next.load(std::memory_order_acquire)) == nullptr) {
+                    cpu_relax();
+                }
+            }
+            next->waiting.store(false, std::memory_order_release);
+            pool().put(me);
+        }
+};
+
+// spin-then-park mutex with the three states of Drepper's
+// "Futexes are tricky": 0 free, 1 locked, 2 locked with sleepers
+class AdaptiveMutex {
+    private:
+        static constexpr unsigned spin_rounds = 100;
+        alignas(cacheline_size) std::atomic<int> state{0};
+
+    public:
+        void lock() {
+            int expected = 0;
+            if (state.compare_exchange_strong(expected, 1,
+                std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+            // spin a little, the owner might be about to unlock
+            for (unsigned i=0; i<spin_rounds; ++i) {
+                cpu_relax();
+                expected = 0;
+                if (state.load(std::memory_order_relaxed) == 0
+                    && state.compare_exchange_weak(expected, 1,
+                        std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+            // go to sleep; whoever takes the lock from here on marks
+            // it with 2, so that unlock knows it has to wake someone
+            while (state.exchange(2, std::memory_order_acquire) != 0) {
+                state.wait(2, std::memory_order_relaxed);
+            }
+        }
+
+        bool try_lock() {
+            int expected = 0;
+            return state.compare_exchange_strong(expected, 1,
+                std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        void unlock() {
+            if (state.exchange(0, std::memory_order_release) == 2) {
+                state.notify_one();
+            }
+        }
+};
+
+// ############ Benchmark ##############
+// shared data of the critical section, on its own cache lines
+struct alignas(cacheline_size) Shared {
+    std::uint64_t values[16] = {};
+};
+
+// every thread acquires the lock 'iterations' times and does
+// 'work' updates of the shared data inside the critical section
+template <typename Mutex>
+double run(std::size_t threads, std::size_t iterations, std::size_t work) {
+    Mutex m;
+    Shared shared;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t<threads; ++t) {
+        workers.emplace_back([&m, &shared, iterations, work]() {
+            for (std::size_t i=0; i<iterations; ++i) {
+                Lock<Mutex> lock(m);
+                for (std::size_t k=0; k<=work; ++k) {
+                    shared.values[k % 16] += 1;
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    if (shared.values[0] < threads * iterations) {
+        std::cout << "lost updates!" << std::endl;
+    }
+    return dt.count() * 1e9 / (threads * iterations);
+}
+
+
+int main() {
+    // all of them work with Lock<T>
+    SpinLock s;
+    {
+        Lock<SpinLock> lock(s);
+    }
+    McsLock q;
+    {
+        Lock<McsLock> lock(q, std::try_to_lock);
+        std::cout << "McsLock acquired with try_lock: " << lock.owns_lock()
+            << std::endl;
+    }
+
+    // spin locks are meant for threads that run at the same time,
+    // so there are never more threads than cores
+    std::size_t max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads=1; threads<max_threads; threads*=2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+    std::cout << "ns per acquisition (" << std::thread::hardware_concurrency()
+        << " cores)" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(6) << "work"
+        << std::setw(12) << "std::mutex" << std::setw(10) << "SpinLock"
+        << std::setw(12) << "TicketLock" << std::setw(10) << "McsLock"
+        << std::setw(15) << "AdaptiveMutex" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (std::size_t threads : thread_counts) {
+        for (std::size_t work : {0, 20, 200}) {
+            const std::size_t iterations = 400000 / threads;
+            std::cout << std::setw(8) << threads << std::setw(6) << work
+                << std::setw(12) << run<std::mutex>(threads, iterations, work)
+                << std::setw(10) << run<SpinLock>(threads, iterations, work)
+                << std::setw(12) << run<TicketLock>(threads, iterations, work)
+                << std::setw(10) << run<McsLock>(threads, iterations, work)
+                << std::setw(15) << run<AdaptiveMutex>(threads, iterations, work)
+                << std::endl;
+        }
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
@@ -0,0 +1,803 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    std::async starts a new thread for every call, and the only way to
+    use the result of a std::future is get(), which blocks the calling
+    thread. A chain of dependent tasks built from std::async therefore
+    needs one (mostly waiting) thread per link.
+    This file builds the dependencies into the futures instead:
+        - Future<T>::then(f) registers f as continuation; f runs on the
+          thread pool as soon as the value is there, no thread waits
+        - when_all / when_any give a future that is ready when all /
+          the first of a number of futures are ready
+        - Task<T> is a c++20 coroutine. "co_await future" suspends the
+          coroutine and registers its resumption as continuation, so
+          the thread goes on with other work in the meantime. A Task
+          starts lazily, when it is awaited or passed to spawn().
+    With this a fixed number of threads can work through graphs with
+    many thousands of tasks in flight.
+    As std::future, a Future is consumed by get() or then(); an
+    exception in a task is passed on to the continuations and
+    rethrown by get().
+
+    The main function runs a long chain, a wide graph and a tree of
+    coroutines and compares the chain with std::async.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <functional>
+#include <optional>
+#include <variant>
+#include <vector>
+#include <deque>
+#include <string>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// ############ Thread pool ##############
+// type-erased job; continuations are move-only
+class Job {
+    public:
+        virtual ~Job() = default;
+        virtual void run() = 0;
+};
+
+template <typename F>
+class FunctionJob : public Job {
+    private:
+        F f;
+
+    public:
+        template <typename G>
+        explicit FunctionJob(G&& function) : f(std::forward<G>(function)) {
+        }
+
+        void run() override {
+            f();
+        }
+};
+
+template <typename F>
+std::unique_ptr<Job> make_job(F&& f) {
+    return std::make_unique<FunctionJob<std::decay_t<F>>>(std::forward<F>(f));
+}
+
+// a simple pool with one queue (see "../parallelization/work-stealing-pool.cpp"
+// for a faster one); the destructor runs all remaining jobs
+class ThreadPool {
+    private:
+        std::vector<std::thread> threads;
+        std::mutex m;
+        std::condition_variable cv;
+        std::deque<std::unique_ptr<Job>> jobs;
+        bool stopping = false;
+
+        void work() {
+            for (;;) {
+                std::unique_ptr<Job> job;
+                {
+                    std::unique_lock<std::mutex> lock(m);
+                    cv.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                    if (jobs.empty()) {
+                        return;
+                    }
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+                job->run();
+            }
+        }
+
+    public:
+        explicit ThreadPool(std::size_t n = std::thread::hardware_concurrency()) {
+            for (std::size_t i=0; i<std::max<std::size_t>(n, 1); ++i) {
+                threads.emplace_back(&ThreadPool::work, this);
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                stopping = true;
+            }
+            cv.notify_all();
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const {
+            return threads.size();
+        }
+
+        void post_job(std::unique_ptr<Job> job) {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                jobs.push_back(std::move(job));
+            }
+            cv.notify_one();
+        }
+
+        template <typename F>
+        void post(F&& f) {
+            post_job(make_job(std::forward<F>(f)));
+        }
+
+        // "co_await pool.schedule()" continues the coroutine on the pool
+        auto schedule() {
+            struct Awaiter {
+                ThreadPool& pool;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> h) {
+                    pool.post([h]() { h.resume(); });
+                }
+
+                void await_resume() const noexcept {
+                }
+            };
+            return Awaiter{*this};
+        }
+};
+
+// ############ Future and Promise ##############
+// futures of void store an empty value
+template <typename T>
+using Value = std::conditional_t<std::is_void<T>::value, std::monostate, T>;
+
+// state shared between a promise and its future; the continuations
+// are posted to the executor (or run directly without one)
+template <typename T>
+class SharedState {
+    private:
+        std::mutex m;
+        std::condition_variable cv;
+        bool ready = false;
+        std::optional<Value<T>> value;
+        std::exception_ptr error;
+        std::vector<std::unique_ptr<Job>> continuations;
+
+        void dispatch(std::unique_ptr<Job> job) {
+            if (executor != nullptr) {
+                executor->post_job(std::move(job));
+            } else {
+                job->run();
+            }
+        }
+
+        template <typename F>
+        void complete(F store) {
+            std::vector<std::unique_ptr<Job>> jobs;
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if (ready) {
+                    throw std::future_error(std::future_errc::promise_already_satisfied);
+                }
+                store();
+                ready = true;
+                jobs.swap(continuations);
+            }
+            cv.notify_all();
+            for (auto& job : jobs) {
+                dispatch(std::move(job));
+            }
+        }
+
+    public:
+        ThreadPool* const executor;
+
+        explicit SharedState(ThreadPool* ex = nullptr) : executor(ex) {
+        }
+
+        void set_value(Value<T> v) {
+            complete([&]() { value.emplace(std::move(v)); });
+        }
+
+        void set_exception(std::exception_ptr e) {
+            complete([&]() { error = e; });
+        }
+
+        bool is_ready() {
+            std::lock_guard<std::mutex> lock(m);
+            return ready;
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [this]() { return ready; });
+        }
+
+        // waits for the value and moves it out
+        Value<T> take() {
+            wait();
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return std::move(*value);
+        }
+
+        // f is called once the state is ready
+        template <typename F>
+        void on_ready(F&& f) {
+            auto job = make_job(std::forward<F>(f));
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if (!ready) {
+                    continuations.push_back(std::move(job));
+                    return;
+                }
+            }
+            dispatch(std::move(job));
+        }
+};
+
+// calls f with the arguments and stores the result in s
+template <typename R, typename F, typename... Args>
+void fulfill(SharedState<R>& s, F& f, Args&&... args) {
+    if constexpr (std::is_void<R>::value) {
+        std::invoke(f, std::forward<Args>(args)...);
+        s.set_value({});
+    } else {
+        s.set_value(std::invoke(f, std::forward<Args>(args)...));
+    }
+}
+
+template <typename T>
+class Future {
+    private:
+        std::shared_ptr<SharedState<T>> state;
+
+    public:
+        Future() = default;
+
+        explicit Future(std::shared_ptr<SharedState<T>> s) : state(std::move(s)) {
+        }
+
+        bool valid() const {
+            return state != nullptr;
+        }
+
+        bool ready() const {
+            return state->is_ready();
+        }
+
+        void wait() const {
+            state->wait();
+        }
+
+        // blocks until the value is there; consumes the future
+        T get() {
+            auto s = std::move(state);
+            if constexpr (std::is_void<T>::value) {
+                s->take();
+            } else {
+                return s->take();
+            }
+        }
+
+        // f is called (without the value) when the future is ready;
+        // the future stays valid
+        template <typename F>
+        void on_ready(F&& f) {
+            state->on_ready(std::forward<F>(f));
+        }
+
+        // returns the future of f(value); f runs on the executor of
+        // this future. An exception is passed on without calling f.
+        // Consumes the future.
+        template <typename F>
+        auto then(F f) {
+            using R = typename std::conditional_t<std::is_void<T>::value,
+                std::invoke_result<F>, std::invoke_result<F, T>>::type;
+            auto src = std::move(state);
+            auto next = std::make_shared<SharedState<R>>(src->executor);
+            src->on_ready([src, next, f = std::move(f)]() mutable {
+                try {
+                    if constexpr (std::is_void<T>::value) {
+                        src->take();
+                        fulfill(*next, f);
+                    } else {
+                        fulfill(*next, f, src->take());
+                    }
+                } catch (...) {
+                    next->set_exception(std::current_exception());
+                }
+            });
+            return Future<R>(next);
+        }
+
+        // "co_await future" in a Task
+        auto operator co_await() {
+            struct Awaiter {
+                Future future;
+
+                bool await_ready() {
+                    return future.ready();
+                }
+
+                void await_suspend(std::coroutine_handle<> h) {
+                    future.on_ready([h]() { h.resume(); });
+                }
+
+                T await_resume() {
+                    return future.get();
+                }
+            };
+            return Awaiter{std::move(*this)};
+        }
+};
+
+// the producing side; a promise that is destroyed without a value
+// reports a broken promise to its future
+template <typename T>
+class Promise {
+    private:
+        std::shared_ptr<SharedState<T>> state;
+
+    public:
+        // continuations run on ex, or on the thread setting the value
+        explicit Promise(ThreadPool* ex = nullptr) :
+            state(std::make_shared<SharedState<T>>(ex)) {
+        }
+
+        ~Promise() {
+            if (state != nullptr && !state->is_ready()) {
+                state->set_exception(std::make_exception_ptr(
+                    std::future_error(std::future_errc::broken_promise)));
+            }
+        }
+
+        Promise(Promise&&) noexcept = default;
+        Promise& operator=(Promise&&) noexcept = default;
+        Promise(const Promise&) = delete;
+        Promise& operator=(const Promise&) = delete;
+
+        Future<T> get_future() {
+            return Future<T>(state);
+        }
+
+        template <typename... V>
+        void set_value(V&&... v) {
+            state->set_value(Value<T>(std::forward<V>(v)...));
+        }
+
+        void set_exception(std::exception_ptr e) {
+            state->set_exception(e);
+        }
+};
+
+// runs f on the pool
+template <typename F>
+auto spawn(ThreadPool& pool, F f) {
+    using R = std::invoke_result_t<F>;
+    auto state = std::make_shared<SharedState<R>>(&pool);
+    pool.post([state, f = std::move(f)]() mutable {
+        try {
+            fulfill(*state, f);
+        } catch (...) {
+            state->set_exception(std::current_exception());
+        }
+    });
+    return Future<R>(state);
+}
+
+// ready when all futures are ready; the futures are handed back
+// (ready), so get() on them does not block
+template <typename T>
+Future<std::vector<Future<T>>> when_all(std::vector<Future<T>> futures) {
+    using Result = std::vector<Future<T>>;
+    struct Shared {
+        Result futures;
+        // one more than the futures: the registration loop below must
+        // finish before the vector may be moved into the result
+        std::atomic<std::size_t> remaining;
+        std::shared_ptr<SharedState<Result>> result = std::make_shared<SharedState<Result>>();
+    };
+    auto shared = std::make_shared<Shared>();
+    shared->remaining.store(futures.size() + 1, std::memory_order_relaxed);
+    shared->futures = std::move(futures);
+    auto arrive = [shared]() {
+        if (shared->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            shared->result->set_value(std::move(shared->futures));
+        }
+    };
+    for (Future<T>& f : shared->futures) {
+        f.on_ready(arrive);
+    }
+    Future<Result> result(shared->result);
+    arrive();
+    return result;
+}
+
+template <typename T>
+struct WhenAnyResult {
+    std::size_t index;
+    std::vector<Future<T>> futures;
+};
+
+// ready when the first future is ready; index tells which one
+template <typename T>
+Future<WhenAnyResult<T>> when_any(std::vector<Future<T>> futures) {
+    using Result = WhenAnyResult<T>;
+    struct Shared {
+        std::vector<Future<T>> futures;
+        std::atomic<std::size_t> winner{static_cast<std::size_t>(-1)};
+        // the winner and the end of the registration loop
+        std::atomic<int> arrivals{0};
+        std::shared_ptr<SharedState<Result>> result = std::make_shared<SharedState<Result>>();
+
+        void arrive() {
+            if (arrivals.fetch_add(1, std::memory_order_acq_rel) == 1) {
+                result->set_value(Result{winner.load(std::memory_order_relaxed),
+                    std::move(futures)});
+            }
+        }
+    };
+    if (futures.empty()) {
+        throw std::invalid_argument("when_any needs at least one future");
+    }
+    auto shared = std::make_shared<Shared>();
+    shared->futures = std::move(futures);
+    for (std::size_t i=0; i<shared->futures.size(); ++i) {
+        shared->futures[i].on_ready([shared, i]() {
+            std::size_t none = static_cast<std::size_t>(-1);
+            if (shared->winner.compare_exchange_strong(none, i, std::memory_order_acq_rel)) {
+                shared->arrive();
+            }
+        });
+    }
+    Future<Result> result(shared->result);
+    shared->arrive();
+    return result;
+}
+
+// ############ Coroutines ##############
+template <typename T>
+class Task;
+
+// the awaiting coroutine is resumed directly when the task
+// finishes (symmetric transfer, no recursion on the stack)
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+            return h.promise().continuation;
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    // lazy start
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() {
+        error = std::current_exception();
+    }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& v) {
+        value.emplace(std::forward<U>(v));
+    }
+
+    T result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() {
+    }
+
+    void result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+// owns the coroutine frame
+template <typename T = void>
+class [[nodiscard]] Task {
+    public:
+        using promise_type = TaskPromise<T>;
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+    public:
+        explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {
+        }
+
+        ~Task() {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {
+        }
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (handle) {
+                    handle.destroy();
+                }
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        // starts the task; the awaiting coroutine continues when it is done
+        auto operator co_await() noexcept {
+            struct Awaiter {
+                std::coroutine_handle<promise_type> h;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    h.promise().continuation = awaiting;
+                    return h;
+                }
+
+                T await_resume() {
+                    return h.promise().result();
+                }
+            };
+            return Awaiter{handle};
+        }
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// coroutine that starts immediately and destroys itself at the end
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() {
+        }
+
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+};
+
+// starts the task on the pool; the result comes as a future
+template <typename T>
+Future<T> spawn(ThreadPool& pool, Task<T> task) {
+    auto state = std::make_shared<SharedState<T>>(&pool);
+    // the parameters are copied into the coroutine frame, so the
+    // lambda must not capture anything
+    [](ThreadPool& pool, Task<T> task, std::shared_ptr<SharedState<T>> state) -> Detached {
+        co_await pool.schedule();
+        try {
+            if constexpr (std::is_void<T>::value) {
+                co_await std::move(task);
+                state->set_value({});
+            } else {
+                state->set_value(co_await std::move(task));
+            }
+        } catch (...) {
+            state->set_exception(std::current_exception());
+        }
+    }(pool, std::move(task), state);
+    return Future<T>(state);
+}
+
+// ############ Benchmark ##############
+constexpr std::size_t chain_length = 10000;
+constexpr std::size_t async_chain_length = 1000;
+constexpr std::size_t graph_width = 1000;
+constexpr std::size_t graph_depth = 100;
+constexpr unsigned tree_depth = 16;
+
+template <typename Func>
+double measure(Func f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    return dt.count();
+}
+
+// every node of the binary tree runs the left subtree in parallel
+// and the right one in the same coroutine; returns the number of nodes
+Task<std::uint64_t> count_tree(ThreadPool& pool, unsigned depth) {
+    if (depth == 0) {
+        co_return 1;
+    }
+    Future<std::uint64_t> left = spawn(pool, count_tree(pool, depth - 1));
+    std::uint64_t right = co_await count_tree(pool, depth - 1);
+    co_return 1 + right + co_await std::move(left);
+}
+
+
+int main() {
+    ThreadPool pool;
+
+    // continuations and error propagation
+    auto answer = spawn(pool, []() { return 6; })
+        .then([](int x) { return x * 7; })
+        .then([](int x) { return std::to_string(x); });
+    std::cout << "answer: " << answer.get() << std::endl;
+    auto failed = spawn(pool, []() -> int { throw std::runtime_error("first stage failed"); })
+        .then([](int x) { return x + 1; });
+    try {
+        failed.get();
+    } catch (const std::exception& e) {
+        std::cout << "exception passed on: " << e.what() << std::endl;
+    }
+
+    // the first of three, then all of them
+    std::vector<Future<int>> racers;
+    for (int i=0; i<3; ++i) {
+        racers.push_back(spawn(pool, [i]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10 * (3 - i)));
+            return i;
+        }));
+    }
+    WhenAnyResult<int> first = when_any(std::move(racers)).get();
+    std::cout << "first ready: racer " << first.index << std::endl;
+    int sum = 0;
+    for (Future<int>& f : when_all(std::move(first.futures)).get()) {
+        sum += f.get();
+    }
+    std::cout << "sum of all racers: " << sum << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "pool with " << pool.size() << " threads" << std::endl;
+
+    // a chain of dependent tasks: with then() no thread waits, with
+    // std::async every link is a thread blocked in get()
+    double t = measure([&pool]() {
+        Future<std::uint64_t> f = spawn(pool, []() { return std::uint64_t(0); });
+        for (std::size_t i=0; i<chain_length; ++i) {
+            f = f.then([](std::uint64_t x) { return x + 1; });
+        }
+        if (f.get() != chain_length) {
+            std::cout << "wrong chain result!" << std::endl;
+        }
+    });
+    std::cout << "chain of " << chain_length << " continuations:    "
+        << t * 1e6 / chain_length << " us per link" << std::endl;
+    t = measure([]() {
+        std::future<std::uint64_t> f = std::async(std::launch::async,
+            []() { return std::uint64_t(0); });
+        for (std::size_t i=0; i<async_chain_length; ++i) {
+            f = std::async(std::launch::async,
+                [prev = std::move(f)]() mutable { return prev.get() + 1; });
+        }
+        if (f.get() != async_chain_length) {
+            std::cout << "wrong chain result!" << std::endl;
+        }
+    });
+    std::cout << "chain of " << async_chain_length << " std::async calls:  "
+        << t * 1e6 / async_chain_length << " us per link" << std::endl;
+
+    // many chains in flight at the same time, joined by when_all
+    t = measure([&pool]() {
+        std::vector<Future<std::uint64_t>> chains;
+        for (std::size_t c=0; c<graph_width; ++c) {
+            Future<std::uint64_t> f = spawn(pool, [c]() { return std::uint64_t(c); });
+            for (std::size_t d=0; d<graph_depth; ++d) {
+                f = f.then([](std::uint64_t x) { return x + 1; });
+            }
+            chains.push_back(std::move(f));
+        }
+        std::uint64_t total = 0;
+        for (Future<std::uint64_t>& f : when_all(std::move(chains)).get()) {
+            total += f.get();
+        }
+        if (total != graph_width * (graph_width - 1) / 2 + graph_width * graph_depth) {
+            std::cout << "wrong graph result!" << std::endl;
+        }
+    });
+    std::cout << graph_width << " chains of " << graph_depth << " in flight:     "
+        << graph_width * graph_depth / t / 1e6 << " million tasks per second" << std::endl;
+
+    // coroutines waiting for each other without blocking a thread
+    std::uint64_t nodes = 0;
+    t = measure([&pool, &nodes]() {
+        nodes = spawn(pool, count_tree(pool, tree_depth)).get();
+    });
+    std::cout << "tree of " << nodes << " coroutines:        "
+        << nodes / t / 1e6 << " million coroutines per second" << std::endl;
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
@@ -0,0 +1,857 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    Matrix-matrix product C = alpha*A*B + beta*C after Goto and van de
+    Geijn ("Anatomy of high-performance matrix multiplication", 2008)
+    for float and double. The three loops around the micro-kernel
+    block for the caches:
+        for jc in steps of nc:          B panel kc x nc in L3
+          for pc in steps of kc:
+            pack B(pc:pc+kc, jc:jc+nc)
+            for ic in steps of mc:      A block mc x kc in L2
+              pack A(ic:ic+mc, pc:pc+kc)
+              for jr in steps of nr:    B micro-panel kc x nr in L1
+                for ir in steps of mr:
+                  micro-kernel: C(ir, jr) += A panel * B micro-panel
+    Packing copies the blocks into aligned Buffers in exactly the order
+    in which the micro-kernel reads them, so it streams through
+    contiguous memory whatever the strides of A and B are (any
+    MatrixView, e.g. a transposed one). Edges are padded with zeros and
+    the micro-kernel always computes a full mr x nr tile.
+
+    The micro-kernel keeps the mr x nr tile of C in registers: for every
+    p it loads one row of the B micro-panel (two vectors) and
+    broadcasts mr elements of A, i.e. 2*mr FMAs for 2 loads and mr
+    broadcasts. There are AVX-512 (8 x 2 vectors), AVX2+FMA (6 x 2
+    vectors) and portable kernels, chosen at runtime as in "gemv.cpp".
+    kc, mc and nc follow from the cache sizes reported by sysconf.
+
+    The threads of a fork-join pool first pack the B panel together and
+    then share the (ic, jr) iterations: every thread takes its own
+    blocks of rows of C (the M loop); if there are fewer blocks than
+    threads, the columns (the N loop) are split as well.
+
+    The main function checks the result against a naive triple loop
+    and compares the GFLOP/s of both.
+        g++ -std=c++20 -O3 -pthread gemm.cpp
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <span>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GEMM_X86 1
+#include <immintrin.h>
+#endif
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+constexpr std::size_t cacheline_alignment = 64;
+
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Buffer class from memory-management.cpp ##############
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// ############ Strided view ##############
+template <typename T>
+class MatrixView {
+    private:
+        T* data_;
+        std::size_t rows_;
+        std::size_t cols_;
+        std::ptrdiff_t row_stride_;
+        std::ptrdiff_t col_stride_;
+
+    public:
+        using value_type = std::remove_const_t<T>;
+        using is_Layout = std::true_type;
+        using is_Strided = std::true_type;
+        using is_Tiled = std::false_type;
+
+        MatrixView(T* data, std::size_t rows, std::size_t cols,
+            std::ptrdiff_t row_stride, std::ptrdiff_t col_stride) :
+            data_(data),
+            rows_(rows),
+            cols_(cols),
+            row_stride_(row_stride),
+            col_stride_(col_stride) {
+        }
+
+        // a view of non-const elements converts to a const view
+        operator MatrixView<const T>() const {
+            return MatrixView<const T>(data_, rows_, cols_, row_stride_, col_stride_);
+        }
+
+        T& operator() (std::size_t i, std::size_t j) const {
+            return data_[static_cast<std::ptrdiff_t>(i)*row_stride_
+                + static_cast<std::ptrdiff_t>(j)*col_stride_];
+        }
+
+        std::size_t rows() const {
+            return rows_;
+        }
+
+        std::size_t cols() const {
+            return cols_;
+        }
+
+        std::ptrdiff_t row_stride() const {
+            return row_stride_;
+        }
+
+        std::ptrdiff_t col_stride() const {
+            return col_stride_;
+        }
+
+        T* data() const {
+            return data_;
+        }
+
+        MatrixView transposed() const {
+            return MatrixView(data_, cols_, rows_, col_stride_, row_stride_);
+        }
+
+        MatrixView block(std::size_t i, std::size_t j, std::size_t r, std::size_t c) const {
+            if (i + r > rows_ || j + c > cols_) {
+                throw std::out_of_range("block exceeds the matrix");
+            }
+            return MatrixView(&(*this)(i, j), r, c, row_stride_, col_stride_);
+        }
+
+        MatrixView row(std::size_t i) const {
+            return block(i, 0, 1, cols_);
+        }
+
+        MatrixView col(std::size_t j) const {
+            return block(0, j, rows_, 1);
+        }
+};
+
+// ############ Fork-join pool from openmp-backends.cpp ##############
+constexpr std::size_t cacheline_size = 64;
+
+// Runs a function on all threads at once and waits for all of them.
+// The calling thread takes part 0, so the pool starts size()-1
+// threads. Waiting threads sleep on an atomic (futex). Not reentrant:
+// a job must not call run() itself.
+class ForkJoinPool {
+    private:
+        std::vector<std::thread> threads;
+        std::function<void(std::size_t)> job;
+        alignas(cacheline_size) std::atomic<std::uint32_t> generation{0};
+        alignas(cacheline_size) std::atomic<std::size_t> pending{0};
+        std::atomic<bool> stopping{false};
+
+        void work(std::size_t index) {
+            std::uint32_t seen = 0;
+            for (;;) {
+                generation.wait(seen, std::memory_order_acquire);
+                seen = generation.load(std::memory_order_acquire);
+                if (stopping.load(std::memory_order_acquire)) {
+                    return;
+                }
+                job(index);
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pending.notify_one();
+                }
+            }
+        }
+
+    public:
+        explicit ForkJoinPool(std::size_t n = std::thread::hardware_concurrency()) {
+            for (std::size_t i=1; i<std::max<std::size_t>(n, 1); ++i) {
+                threads.emplace_back(&ForkJoinPool::work, this, i);
+            }
+        }
+
+        ~ForkJoinPool() {
+            stopping.store(true, std::memory_order_release);
+            generation.fetch_add(1, std::memory_order_release);
+            generation.notify_all();
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+
+        ForkJoinPool(const ForkJoinPool&) = delete;
+        ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+        std::size_t size() const {
+            return threads.size() + 1;
+        }
+
+        // calls f(t) for t = 0 .. size()-1 in parallel
+        template <typename F>
+        void run(F&& f) {
+            job = std::ref(f);
+            pending.store(threads.size(), std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            generation.notify_all();
+            f(0);
+            std::size_t p;
+            while ((p = pending.load(std::memory_order_acquire)) != 0) {
+                pending.wait(p, std::memory_order_acquire);
+            }
+        }
+};
+
+// ############ Micro-kernels ##############
+// ab (mr x nr, row-major) = sum over p < kc of a[p*mr + i] * b[p*nr + j]
+template <typename T>
+using MicroKernel = void (*)(std::size_t kc, const T* a, const T* b, T* ab);
+
+template <typename T>
+struct GemmKernel {
+    const char* name;
+    std::size_t mr;
+    std::size_t nr;
+    MicroKernel<T> run;
+};
+
+// portable: 4 x 8, the compiler vectorizes the inner loop
+constexpr std::size_t portable_mr = 4;
+constexpr std::size_t portable_nr = 8;
+
+template <typename T>
+void micro_kernel_portable(std::size_t kc, const T* a, const T* b, T* ab) {
+    constexpr std::size_t mr = portable_mr;
+    constexpr std::size_t nr = portable_nr;
+    T c[mr][nr] = {};
+    for (std::size_t p=0; p<kc; ++p) {
+        for (std::size_t i=0; i<mr; ++i) {
+            const T ai = a[p*mr + i];
+            for (std::size_t j=0; j<nr; ++j) {
+                c[i][j] += ai * b[p*nr + j];
+            }
+        }
+    }
+    for (std::size_t i=0; i<mr; ++i) {
+        for (std::size_t j=0; j<nr; ++j) {
+            ab[i*nr + j] = c[i][j];
+        }
+    }
+}
+
+#ifdef GEMM_X86
+// the same kernel for every instruction set: Isa provides the vector
+// type and its operations; the accumulators are 2*MR registers. The
+// body has no target of its own, the wrappers below inline it (and
+// the operations of Isa) with 'flatten', so the vectors never cross a
+// call with the default ABI the compiler warns about.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+template <typename Isa, std::size_t MR>
+inline void micro_kernel_body(std::size_t kc,
+    const typename Isa::scalar* a, const typename Isa::scalar* b, typename Isa::scalar* ab) {
+    using V = typename Isa::vec;
+    constexpr std::size_t lanes = Isa::lanes;
+    constexpr std::size_t nr = 2 * lanes;
+    V c0[MR], c1[MR];
+    for (std::size_t i=0; i<MR; ++i) {
+        c0[i] = Isa::zero();
+        c1[i] = Isa::zero();
+    }
+    for (std::size_t p=0; p<kc; ++p) {
+        const V b0 = Isa::load(b + p*nr);
+        const V b1 = Isa::load(b + p*nr + lanes);
+#pragma GCC unroll 8
+        for (std::size_t i=0; i<MR; ++i) {
+            const V ai = Isa::broadcast(a + p*MR + i);
+            c0[i] = Isa::fmadd(ai, b0, c0[i]);
+            c1[i] = Isa::fmadd(ai, b1, c1[i]);
+        }
+    }
+    for (std::size_t i=0; i<MR; ++i) {
+        Isa::store(ab + i*nr, c0[i]);
+        Isa::store(ab + i*nr + lanes, c1[i]);
+    }
+}
+#pragma GCC diagnostic pop
+
+// the packed buffers are aligned to a cache line and nr*sizeof(T) is
+// a multiple of the vector size, so all loads of b are aligned
+#define GEMM_AVX512 [[gnu::target("avx512f")]] static inline
+#define GEMM_AVX2 [[gnu::target("avx2,fma")]] static inline
+
+template <typename T>
+struct Avx512;
+
+template <>
+struct Avx512<double> {
+    using scalar = double;
+    using vec = __m512d;
+    static constexpr std::size_t lanes = 8;
+    GEMM_AVX512 vec zero() { return _mm512_setzero_pd(); }
+    GEMM_AVX512 vec load(const double* p) { return _mm512_load_pd(p); }
+    GEMM_AVX512 vec broadcast(const double* p) { return _mm512_set1_pd(*p); }
+    GEMM_AVX512 vec fmadd(vec a, vec b, vec c) { return _mm512_fmadd_pd(a, b, c); }
+    GEMM_AVX512 void store(double* p, vec v) { _mm512_storeu_pd(p, v); }
+};
+
+template <>
+struct Avx512<float> {
+    using scalar = float;
+    using vec = __m512;
+    static constexpr std::size_t lanes = 16;
+    GEMM_AVX512 vec zero() { return _mm512_setzero_ps(); }
+    GEMM_AVX512 vec load(const float* p) { return _mm512_load_ps(p); }
+    GEMM_AVX512 vec broadcast(const float* p) { return _mm512_set1_ps(*p); }
+    GEMM_AVX512 vec fmadd(vec a, vec b, vec c) { return _mm512_fmadd_ps(a, b, c); }
+    GEMM_AVX512 void store(float* p, vec v) { _mm512_storeu_ps(p, v); }
+};
+
+template <typename T>
+struct Avx2;
+
+template <>
+struct Avx2<double> {
+    using scalar = double;
+    using vec = __m256d;
+    static constexpr std::size_t lanes = 4;
+    GEMM_AVX2 vec zero() { return _mm256_setzero_pd(); }
+    GEMM_AVX2 vec load(const double* p) { return _mm256_load_pd(p); }
+    GEMM_AVX2 vec broadcast(const double* p) { return _mm256_broadcast_sd(p); }
+    GEMM_AVX2 vec fmadd(vec a, vec b, vec c) { return _mm256_fmadd_pd(a, b, c); }
+    GEMM_AVX2 void store(double* p, vec v) { _mm256_storeu_pd(p, v); }
+};
+
+template <>
+struct Avx2<float> {
+    using scalar = float;
+    using vec = __m256;
+    static constexpr std::size_t lanes = 8;
+    GEMM_AVX2 vec zero() { return _mm256_setzero_ps(); }
+    GEMM_AVX2 vec load(const float* p) { return _mm256_load_ps(p); }
+    GEMM_AVX2 vec broadcast(const float* p) { return _mm256_broadcast_ss(p); }
+    GEMM_AVX2 vec fmadd(vec a, vec b, vec c) { return _mm256_fmadd_ps(a, b, c); }
+    GEMM_AVX2 void store(float* p, vec v) { _mm256_storeu_ps(p, v); }
+};
+
+#undef GEMM_AVX512
+#undef GEMM_AVX2
+
+// 16 of the 32 zmm registers hold C
+constexpr std::size_t avx512_mr = 8;
+// 12 of the 16 ymm registers hold C
+constexpr std::size_t avx2_mr = 6;
+
+template <typename T>
+[[gnu::target("avx512f"), gnu::flatten]]
+void micro_kernel_avx512(std::size_t kc, const T* a, const T* b, T* ab) {
+    micro_kernel_body<Avx512<T>, avx512_mr>(kc, a, b, ab);
+}
+
+template <typename T>
+[[gnu::target("avx2,fma"), gnu::flatten]]
+void micro_kernel_avx2(std::size_t kc, const T* a, const T* b, T* ab) {
+    micro_kernel_body<Avx2<T>, avx2_mr>(kc, a, b, ab);
+}
+#endif // of #ifdef GEMM_X86
+
+// the kernels this cpu can run, best first
+template <typename T>
+std::vector<GemmKernel<T>> supported_kernels() {
+    std::vector<GemmKernel<T>> kernels;
+#ifdef GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels.push_back({"avx512", avx512_mr, 2 * Avx512<T>::lanes, micro_kernel_avx512<T>});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels.push_back({"avx2", avx2_mr, 2 * Avx2<T>::lanes, micro_kernel_avx2<T>});
+    }
+#endif
+    kernels.push_back({"portable", portable_mr, portable_nr, micro_kernel_portable<T>});
+    return kernels;
+}
+
+// elements of the largest mr x nr tile of the kernels above
+template <typename T>
+constexpr std::size_t max_tile = std::max({
+#ifdef GEMM_X86
+    avx512_mr * 2 * Avx512<T>::lanes,
+    avx2_mr * 2 * Avx2<T>::lanes,
+#endif
+    portable_mr * portable_nr});
+
+template <typename T>
+const GemmKernel<T>& best_kernel() {
+    static const GemmKernel<T> best = supported_kernels<T>().front();
+    return best;
+}
+
+// ############ Blocking ##############
+inline std::size_t cache_size(int name, std::size_t fallback) {
+    const long size = sysconf(name);
+    return size > 0 ? static_cast<std::size_t>(size) : fallback;
+}
+
+// the block that should stay in a cache takes half of it (a quarter
+// of L2, which also holds the streaming B micro-panels and tiles of C),
+// the rest is left for everything else
+struct Blocking {
+    std::size_t kc;
+    std::size_t mc;
+    std::size_t nc;
+
+    template <typename T>
+    static Blocking of(const GemmKernel<T>& kernel) {
+        const std::size_t l1 = cache_size(_SC_LEVEL1_DCACHE_SIZE, 32 << 10);
+        const std::size_t l2 = cache_size(_SC_LEVEL2_CACHE_SIZE, 1 << 20);
+        const std::size_t l3 = cache_size(_SC_LEVEL3_CACHE_SIZE, 8 << 20);
+        Blocking b;
+        // B micro-panel kc x nr in L1
+        b.kc = std::clamp<std::size_t>(l1 / 2 / (kernel.nr * sizeof(T)), 64, 512);
+        // A block mc x kc in L2
+        b.mc = std::max(kernel.mr,
+            std::min<std::size_t>(l2 / 4 / (b.kc * sizeof(T)), 1024) / kernel.mr * kernel.mr);
+        // B panel kc x nc in L3
+        b.nc = std::max(kernel.nr,
+            std::min<std::size_t>(l3 / 2 / (b.kc * sizeof(T)), 4096) / kernel.nr * kernel.nr);
+        return b;
+    }
+};
+
+// ############ Packing ##############
+// A(ic:ic+mb, pc:pc+kb) as panels of mr rows; inside a panel column
+// after column (mr elements per p)
+template <typename T>
+void pack_a(MatrixView<const T> A, std::size_t ic, std::size_t pc, std::size_t mb,
+    std::size_t kb, std::size_t mr, T* packed) {
+    for (std::size_t i0=0; i0<mb; i0+=mr) {
+        const std::size_t rows = std::min(mr, mb - i0);
+        T* panel = packed + i0*kb;
+        for (std::size_t p=0; p<kb; ++p) {
+            for (std::size_t i=0; i<rows; ++i) {
+                panel[p*mr + i] = A(ic + i0 + i, pc + p);
+            }
+            for (std::size_t i=rows; i<mr; ++i) {
+                panel[p*mr + i] = T{};
+            }
+        }
+    }
+}
+
+// micro-panels first..last of B(pc:pc+kb, jc:jc+nb), each kb x nr, row
+// after row (nr elements per p)
+template <typename T>
+void pack_b(MatrixView<const T> B, std::size_t pc, std::size_t jc, std::size_t kb,
+    std::size_t nb, std::size_t nr, std::size_t first, std::size_t last, T* packed) {
+    for (std::size_t panel=first; panel<last; ++panel) {
+        const std::size_t j0 = panel * nr;
+        const std::size_t cols = std::min(nr, nb - j0);
+        T* out = packed + j0*kb;
+        for (std::size_t p=0; p<kb; ++p) {
+            for (std::size_t j=0; j<cols; ++j) {
+                out[p*nr + j] = B(pc + p, jc + j0 + j);
+            }
+            for (std::size_t j=cols; j<nr; ++j) {
+                out[p*nr + j] = T{};
+            }
+        }
+    }
+}
+
+// ############ GEMM ##############
+// part t of n split into parts pieces
+inline std::pair<std::size_t, std::size_t> chunk(std::size_t n, std::size_t parts,
+    std::size_t t) {
+    return {n * t / parts, n * (t + 1) / parts};
+}
+
+// C = alpha*A*B + beta*C; pool == nullptr runs on the calling thread
+template <typename T>
+void gemm(T alpha, MatrixView<const T> A, MatrixView<const T> B, T beta, MatrixView<T> C,
+    ForkJoinPool* pool = nullptr, const GemmKernel<T>& kernel = best_kernel<T>()) {
+    const std::size_t m = C.rows();
+    const std::size_t n = C.cols();
+    const std::size_t k = A.cols();
+    if (A.rows() != m || B.rows() != k || B.cols() != n) {
+        throw std::invalid_argument("gemm: shapes of A, B and C do not match");
+    }
+    if (m == 0 || n == 0) {
+        return;
+    }
+    if (k == 0 || alpha == T{}) {
+        for (std::size_t i=0; i<m; ++i) {
+            for (std::size_t j=0; j<n; ++j) {
+                C(i, j) = beta == T{} ? T{} : beta * C(i, j);
+            }
+        }
+        return;
+    }
+
+    const std::size_t mr = kernel.mr;
+    const std::size_t nr = kernel.nr;
+    const Blocking blocking = Blocking::of(kernel);
+    const std::size_t threads = pool == nullptr ? 1 : pool->size();
+    const std::size_t kc = std::min(blocking.kc, k);
+    const std::size_t mc = std::min(blocking.mc, (m + mr - 1) / mr * mr);
+    const std::size_t nc = std::min(blocking.nc, (n + nr - 1) / nr * nr);
+
+    Buffer<T, cacheline_alignment> packed_b(kc * nc, uninitialized);
+    std::vector<Buffer<T, cacheline_alignment>> packed_a;
+    for (std::size_t t=0; t<threads; ++t) {
+        packed_a.emplace_back(mc * kc, uninitialized);
+    }
+
+    auto parallel = [&](auto&& f) {
+        if (threads == 1) {
+            f(0);
+        } else {
+            pool->run(f);
+        }
+    };
+
+    for (std::size_t jc=0; jc<n; jc+=nc) {
+        const std::size_t nb = std::min(nc, n - jc);
+        const std::size_t panels = (nb + nr - 1) / nr;
+        for (std::size_t pc=0; pc<k; pc+=kc) {
+            const std::size_t kb = std::min(kc, k - pc);
+            // beta only on the first pass over C
+            const T beta_p = pc == 0 ? beta : T{1};
+
+            parallel([&](std::size_t t) {
+                auto [first, last] = chunk(panels, threads, t);
+                pack_b(B, pc, jc, kb, nb, nr, first, last, packed_b.data());
+            });
+
+            // blocks of rows (M loop), each split into n_parts ranges of
+            // micro-panels (N loop) if there are fewer blocks than threads
+            const std::size_t m_blocks = (m + mc - 1) / mc;
+            const std::size_t n_parts = std::min(panels, std::max<std::size_t>(1, threads / m_blocks));
+            parallel([&](std::size_t t) {
+                // holds the tile of any kernel
+                alignas(cacheline_alignment) T ab[max_tile<T>];
+                std::size_t packed_ic = m;
+                for (std::size_t item=t; item<m_blocks*n_parts; item+=threads) {
+                    const std::size_t ic = item / n_parts * mc;
+                    const std::size_t mb = std::min(mc, m - ic);
+                    if (ic != packed_ic) {
+                        pack_a(A, ic, pc, mb, kb, mr, packed_a[t].data());
+                        packed_ic = ic;
+                    }
+                    auto [first, last] = chunk(panels, n_parts, item % n_parts);
+                    for (std::size_t panel=first; panel<last; ++panel) {
+                        const std::size_t jr = panel * nr;
+                        const std::size_t cols = std::min(nr, nb - jr);
+                        for (std::size_t ir=0; ir<mb; ir+=mr) {
+                            const std::size_t rows = std::min(mr, mb - ir);
+                            kernel.run(kb, packed_a[t].data() + ir*kb, packed_b.data() + jr*kb, ab);
+                            for (std::size_t i=0; i<rows; ++i) {
+                                for (std::size_t j=0; j<cols; ++j) {
+                                    T& c = C(ic + ir + i, jc + jr + j);
+                                    c = beta_p == T{} ? alpha * ab[i*nr + j]
+                                        : alpha * ab[i*nr + j] + beta_p * c;
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+// the textbook triple loop
+template <typename T>
+void gemm_naive(T alpha, MatrixView<const T> A, MatrixView<const T> B, T beta, MatrixView<T> C) {
+    for (std::size_t i=0; i<C.rows(); ++i) {
+        for (std::size_t j=0; j<C.cols(); ++j) {
+            T s = T{};
+            for (std::size_t p=0; p<A.cols(); ++p) {
+                s += A(i, p) * B(p, j);
+            }
+            C(i, j) = beta == T{} ? alpha * s : alpha * s + beta * C(i, j);
+        }
+    }
+}
+
+// ############ Test and benchmark ##############
+// row-major with a leading dimension padded to a cache line
+template <typename T>
+struct TestMatrix {
+    std::size_t m;
+    std::size_t n;
+    std::size_t ld;
+    Buffer<T, cacheline_alignment> storage;
+
+    TestMatrix(std::size_t rows, std::size_t cols, double seed) :
+        m(rows),
+        n(cols),
+        ld((cols + 15) / 16 * 16),
+        storage(rows * ld) {
+        for (std::size_t i=0; i<m; ++i) {
+            for (std::size_t j=0; j<n; ++j) {
+                storage[i*ld + j] = static_cast<T>(std::sin(seed + 0.37*i + 0.11*j));
+            }
+        }
+    }
+
+    MatrixView<T> view() {
+        return MatrixView<T>(storage.data(), m, n, ld, 1);
+    }
+
+    MatrixView<const T> view() const {
+        return MatrixView<const T>(storage.data(), m, n, ld, 1);
+    }
+};
+
+// largest difference, relative to k (the error of both results grows
+// with the number of terms) and the epsilon of T
+template <typename T>
+double scaled_error(MatrixView<const T> C, MatrixView<const T> expected, std::size_t k) {
+    double error = 0.0;
+    for (std::size_t i=0; i<C.rows(); ++i) {
+        for (std::size_t j=0; j<C.cols(); ++j) {
+            error = std::max(error, std::abs(double(C(i, j)) - double(expected(i, j))));
+        }
+    }
+    return error / (std::max<std::size_t>(k, 1) * std::numeric_limits<T>::epsilon());
+}
+
+template <typename T>
+bool check(const char* type, ForkJoinPool& pool) {
+    struct Shape { std::size_t m, k, n; };
+    double worst = 0.0;
+    for (Shape s : {Shape{1, 1, 1}, Shape{7, 13, 5}, Shape{33, 300, 47},
+        Shape{100, 37, 301}, Shape{257, 600, 263}}) {
+        // A given transposed for every second shape
+        TestMatrix<T> a(s.m, s.k, 0.1), at(s.k, s.m, 0.1), b(s.k, s.n, 0.2);
+        for (std::size_t i=0; i<s.m; ++i) {
+            for (std::size_t p=0; p<s.k; ++p) {
+                at.storage[p*at.ld + i] = a.storage[i*a.ld + p];
+            }
+        }
+        for (bool transposed : {false, true}) {
+            MatrixView<const T> A = transposed ? at.view().transposed() : a.view();
+            TestMatrix<T> expected(s.m, s.n, 0.3);
+            gemm_naive<T>(T(1.5), A, b.view(), T(0.5), expected.view());
+            for (const auto& kernel : supported_kernels<T>()) {
+                for (ForkJoinPool* p : {static_cast<ForkJoinPool*>(nullptr), &pool}) {
+                    TestMatrix<T> c(s.m, s.n, 0.3);
+                    gemm<T>(T(1.5), A, b.view(), T(0.5), c.view(), p, kernel);
+                    worst = std::max(worst, scaled_error<T>(c.view(), expected.view(), s.k));
+                }
+            }
+        }
+    }
+    const bool ok = worst < 4.0;
+    std::cout << std::setw(7) << type << ": largest error " << std::setprecision(3) << worst
+        << " x k x epsilon " << (ok ? "(ok)" : "(WRONG)") << std::endl;
+    return ok;
+}
+
+template <typename F>
+double seconds_per_call(F&& f) {
+    std::size_t runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        f();
+        ++runs;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 0.2);
+    return elapsed.count() / runs;
+}
+
+template <typename T>
+void benchmark(const char* type, ForkJoinPool& pool) {
+    const auto& kernel = best_kernel<T>();
+    const Blocking blocking = Blocking::of(kernel);
+    std::cout << std::endl << type << ", kernel " << kernel.name << " (" << kernel.mr << " x "
+        << kernel.nr << "), kc " << blocking.kc << ", mc " << blocking.mc
+        << ", nc " << blocking.nc << std::endl;
+    std::cout << std::setw(6) << "n" << std::setw(14) << "naive GFLOP/s"
+        << std::setw(15) << "packed GFLOP/s" << std::setw(9) << "threads"
+        << std::setw(15) << "packed GFLOP/s" << std::endl;
+    for (std::size_t n : {64, 256, 512, 1024, 2048}) {
+        TestMatrix<T> a(n, n, 0.1), b(n, n, 0.2), c(n, n, 0.3);
+        const double flops = 2.0 * n * n * n;
+        std::cout << std::setw(6) << n << std::fixed << std::setprecision(2);
+        // the naive loop takes seconds beyond 1024
+        if (n <= 1024) {
+            std::cout << std::setw(14) << flops / 1e9 / seconds_per_call([&]() {
+                gemm_naive<T>(T(1), a.view(), b.view(), T(0), c.view());
+            });
+        } else {
+            std::cout << std::setw(14) << "-";
+        }
+        std::cout << std::setw(15) << flops / 1e9 / seconds_per_call([&]() {
+            gemm<T>(T(1), a.view(), b.view(), T(0), c.view());
+        });
+        std::cout << std::setw(9) << pool.size() << std::setw(15) << flops / 1e9 / seconds_per_call([&]() {
+            gemm<T>(T(1), a.view(), b.view(), T(0), c.view(), &pool);
+        }) << std::endl;
+    }
+}
+
+
+int main() {
+    ForkJoinPool pool;
+    const bool ok = check<double>("double", pool) && check<float>("float", pool);
+    if (!ok) {
+        return 1;
+    }
+    benchmark<double>("double", pool);
+    benchmark<float>("float", pool);
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
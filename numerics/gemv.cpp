@@ -0,0 +1,875 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    Fused matrix-vector product y = alpha*A*x + beta*y for doubles.
+    "Fused" means that y is read and written once: the scaling with
+    beta, the product and the scaling with alpha happen in the same
+    pass instead of one pass for beta*y and a second for y += alpha*A*x.
+    For moderate and large matrices GEMV is bound by memory bandwidth
+    (every element of A is used once), so the goal is to stream A at
+    the speed of the memory.
+
+    A is a MatrixView (see "matrix-layouts.cpp"); the kernel is chosen
+    by its strides:
+        - contiguous rows (row-major, or the transposed view of a
+          column-major matrix): one dot product per row; four rows
+          are processed together, so every load of x serves four rows
+        - contiguous columns (column-major, or A.transposed() of a
+          row-major matrix): y += alpha*x[j]*A(:, j), four columns at a
+          time on a block of y that stays in L1
+        - other strides: a plain loop
+    Both kernels exist as AVX-512, AVX2+FMA and portable code. The
+    instruction set is detected at runtime (__builtin_cpu_supports) and
+    the SIMD kernels are compiled with the target attribute, so the file
+    builds without -march=native and runs on every x86-64 cpu (and with
+    the portable kernels on every other platform).
+        g++ -std=c++20 -O3 -pthread gemv.cpp
+
+    Above parallel_threshold elements of A the rows are split between
+    the threads of a fork-join pool; the chunks start at cache-line
+    boundaries of y.
+
+    The main function checks all kernels against a simple loop and
+    reports GB/s together with the bandwidth of the memory, the
+    roofline for a large matrix. Small matrices stay in the caches
+    between the calls and exceed it.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <span>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GEMV_X86 1
+#include <immintrin.h>
+#endif
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+constexpr std::size_t cacheline_alignment = 64;
+
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Buffer class from memory-management.cpp ##############
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// ############ Strided view ##############
+template <typename T>
+class MatrixView {
+    private:
+        T* data_;
+        std::size_t rows_;
+        std::size_t cols_;
+        std::ptrdiff_t row_stride_;
+        std::ptrdiff_t col_stride_;
+
+    public:
+        using value_type = std::remove_const_t<T>;
+        using is_Layout = std::true_type;
+        using is_Strided = std::true_type;
+        using is_Tiled = std::false_type;
+
+        MatrixView(T* data, std::size_t rows, std::size_t cols,
+            std::ptrdiff_t row_stride, std::ptrdiff_t col_stride) :
+            data_(data),
+            rows_(rows),
+            cols_(cols),
+            row_stride_(row_stride),
+            col_stride_(col_stride) {
+        }
+
+        // a view of non-const elements converts to a const view
+        operator MatrixView<const T>() const {
+            return MatrixView<const T>(data_, rows_, cols_, row_stride_, col_stride_);
+        }
+
+        T& operator() (std::size_t i, std::size_t j) const {
+            return data_[static_cast<std::ptrdiff_t>(i)*row_stride_
+                + static_cast<std::ptrdiff_t>(j)*col_stride_];
+        }
+
+        std::size_t rows() const {
+            return rows_;
+        }
+
+        std::size_t cols() const {
+            return cols_;
+        }
+
+        std::ptrdiff_t row_stride() const {
+            return row_stride_;
+        }
+
+        std::ptrdiff_t col_stride() const {
+            return col_stride_;
+        }
+
+        T* data() const {
+            return data_;
+        }
+
+        MatrixView transposed() const {
+            return MatrixView(data_, cols_, rows_, col_stride_, row_stride_);
+        }
+
+        MatrixView block(std::size_t i, std::size_t j, std::size_t r, std::size_t c) const {
+            if (i + r > rows_ || j + c > cols_) {
+                throw std::out_of_range("block exceeds the matrix");
+            }
+            return MatrixView(&(*this)(i, j), r, c, row_stride_, col_stride_);
+        }
+
+        MatrixView row(std::size_t i) const {
+            return block(i, 0, 1, cols_);
+        }
+
+        MatrixView col(std::size_t j) const {
+            return block(0, j, rows_, 1);
+        }
+};
+
+// ############ Fork-join pool from openmp-backends.cpp ##############
+constexpr std::size_t cacheline_size = 64;
+
+// Runs a function on all threads at once and waits for all of them.
+// The calling thread takes part 0, so the pool starts size()-1
+// threads. Waiting threads sleep on an atomic (futex). Not reentrant:
+// a job must not call run() itself.
+class ForkJoinPool {
+    private:
+        std::vector<std::thread> threads;
+        std::function<void(std::size_t)> job;
+        alignas(cacheline_size) std::atomic<std::uint32_t> generation{0};
+        alignas(cacheline_size) std::atomic<std::size_t> pending{0};
+        std::atomic<bool> stopping{false};
+
+        void work(std::size_t index) {
+            std::uint32_t seen = 0;
+            for (;;) {
+                generation.wait(seen, std::memory_order_acquire);
+                seen = generation.load(std::memory_order_acquire);
+                if (stopping.load(std::memory_order_acquire)) {
+                    return;
+                }
+                job(index);
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pending.notify_one();
+                }
+            }
+        }
+
+    public:
+        explicit ForkJoinPool(std::size_t n = std::thread::hardware_concurrency()) {
+            for (std::size_t i=1; i<std::max<std::size_t>(n, 1); ++i) {
+                threads.emplace_back(&ForkJoinPool::work, this, i);
+            }
+        }
+
+        ~ForkJoinPool() {
+            stopping.store(true, std::memory_order_release);
+            generation.fetch_add(1, std::memory_order_release);
+            generation.notify_all();
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+
+        ForkJoinPool(const ForkJoinPool&) = delete;
+        ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+        std::size_t size() const {
+            return threads.size() + 1;
+        }
+
+        // calls f(t) for t = 0 .. size()-1 in parallel
+        template <typename F>
+        void run(F&& f) {
+            job = std::ref(f);
+            pending.store(threads.size(), std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            generation.notify_all();
+            f(0);
+            std::size_t p;
+            while ((p = pending.load(std::memory_order_acquire)) != 0) {
+                pending.wait(p, std::memory_order_acquire);
+            }
+        }
+};
+
+// ############ Kernels ##############
+// All kernels compute y[0, m) for an m x n matrix with leading
+// dimension lda: rows kernels read a[i*lda + j], column kernels
+// a[i + j*lda]. With beta == 0, y is only written (as in BLAS, so
+// NaNs in an uninitialized y do not propagate).
+using GemvKernel = void (*)(const double* a, std::size_t lda, std::size_t m, std::size_t n,
+    double alpha, const double* x, double beta, double* y);
+
+// elements of y per block in the column kernels (8 KiB)
+constexpr std::size_t column_block = 1024;
+
+inline double finish(double dot, double alpha, double beta, double y) {
+    return beta == 0.0 ? alpha * dot : alpha * dot + beta * y;
+}
+
+// the beta part of a block of y, before the columns are added
+inline void scale_block(double beta, double* y, std::size_t m) {
+    for (std::size_t i=0; i<m; ++i) {
+        y[i] = beta == 0.0 ? 0.0 : beta * y[i];
+    }
+}
+
+// portable
+void gemv_rows_portable(const double* a, std::size_t lda, std::size_t m, std::size_t n,
+    double alpha, const double* x, double beta, double* y) {
+    std::size_t i = 0;
+    for (; i+4<=m; i+=4) {
+        const double* a0 = a + i*lda;
+        const double* a1 = a0 + lda;
+        const double* a2 = a1 + lda;
+        const double* a3 = a2 + lda;
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        for (std::size_t j=0; j<n; ++j) {
+            s0 += a0[j] * x[j];
+            s1 += a1[j] * x[j];
+            s2 += a2[j] * x[j];
+            s3 += a3[j] * x[j];
+        }
+        y[i] = finish(s0, alpha, beta, y[i]);
+        y[i+1] = finish(s1, alpha, beta, y[i+1]);
+        y[i+2] = finish(s2, alpha, beta, y[i+2]);
+        y[i+3] = finish(s3, alpha, beta, y[i+3]);
+    }
+    for (; i<m; ++i) {
+        double s = 0.0;
+        for (std::size_t j=0; j<n; ++j) {
+            s += a[i*lda + j] * x[j];
+        }
+        y[i] = finish(s, alpha, beta, y[i]);
+    }
+}
+
+void gemv_columns_portable(const double* a, std::size_t lda, std::size_t m, std::size_t n,
+    double alpha, const double* x, double beta, double* y) {
+    for (std::size_t i0=0; i0<m; i0+=column_block) {
+        const std::size_t rows = std::min(column_block, m - i0);
+        double* yb = y + i0;
+        scale_block(beta, yb, rows);
+        std::size_t j = 0;
+        for (; j+4<=n; j+=4) {
+            const double* a0 = a + i0 + j*lda;
+            const double* a1 = a0 + lda;
+            const double* a2 = a1 + lda;
+            const double* a3 = a2 + lda;
+            const double c0 = alpha*x[j], c1 = alpha*x[j+1], c2 = alpha*x[j+2], c3 = alpha*x[j+3];
+            for (std::size_t i=0; i<rows; ++i) {
+                yb[i] += c0*a0[i] + c1*a1[i] + c2*a2[i] + c3*a3[i];
+            }
+        }
+        for (; j<n; ++j) {
+            const double* a0 = a + i0 + j*lda;
+            const double c0 = alpha*x[j];
+            for (std::size_t i=0; i<rows; ++i) {
+                yb[i] += c0*a0[i];
+            }
+        }
+    }
+}
+
+#ifdef GEMV_X86
+// AVX2 + FMA: 4 doubles per register
+__attribute__((target("avx2,fma")))
+inline double hsum_avx2(__m256d v) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+__attribute__((target("avx2,fma")))
+void gemv_rows_avx2(const double* a, std::size_t lda, std::size_t m, std::size_t n,
+    double alpha, const double* x, double beta, double* y) {
+    std::size_t i = 0;
+    for (; i+4<=m; i+=4) {
+        const double* a0 = a + i*lda;
+        const double* a1 = a0 + lda;
+        const double* a2 = a1 + lda;
+        const double* a3 = a2 + lda;
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+        std::size_t j = 0;
+        for (; j+4<=n; j+=4) {
+            const __m256d xv = _mm256_loadu_pd(x + j);
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a0 + j), xv, s0);
+            s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a1 + j), xv, s1);
+            s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a2 + j), xv, s2);
+            s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a3 + j), xv, s3);
+        }
+        double t0 = hsum_avx2(s0), t1 = hsum_avx2(s1), t2 = hsum_avx2(s2), t3 = hsum_avx2(s3);
+        for (; j<n; ++j) {
+            t0 += a0[j] * x[j];
+            t1 += a1[j] * x[j];
+            t2 += a2[j] * x[j];
+            t3 += a3[j] * x[j];
+        }
+        y[i] = finish(t0, alpha, beta, y[i]);
+        y[i+1] = finish(t1, alpha, beta, y[i+1]);
+        y[i+2] = finish(t2, alpha, beta, y[i+2]);
+        y[i+3] = finish(t3, alpha, beta, y[i+3]);
+    }
+    for (; i<m; ++i) {
+        const double* a0 = a + i*lda;
+        __m256d s = _mm256_setzero_pd();
+        std::size_t j = 0;
+        for (; j+4<=n; j+=4) {
+            s = _mm256_fmadd_pd(_mm256_loadu_pd(a0 + j), _mm256_loadu_pd(x + j), s);
+        }
+        double t = hsum_avx2(s);
+        for (; j<n; ++j) {
+            t += a0[j] * x[j];
+        }
+        y[i] = finish(t, alpha, beta, y[i]);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void gemv_columns_avx2(const double* a, std::size_t lda, std::size_t m, std::size_t n,
+    double alpha, const double* x, double beta, double* y) {
+    for (std::size_t i0=0; i0<m; i0+=column_block) {
+        const std::size_t rows = std::min(column_block, m - i0);
+        double* yb = y + i0;
+        scale_block(beta, yb, rows);
+        std::size_t j = 0;
+        for (; j+4<=n; j+=4) {
+            const double* a0 = a + i0 + j*lda;
+            const double* a1 = a0 + lda;
+            const double* a2 = a1 + lda;
+            const double* a3 = a2 + lda;
+            const double c0 = alpha*x[j], c1 = alpha*x[j+1], c2 = alpha*x[j+2], c3 = alpha*x[j+3];
+            const __m256d v0 = _mm256_set1_pd(c0), v1 = _mm256_set1_pd(c1);
+            const __m256d v2 = _mm256_set1_pd(c2), v3 = _mm256_set1_pd(c3);
+            std::size_t i = 0;
+            for (; i+4<=rows; i+=4) {
+                __m256d acc = _mm256_loadu_pd(yb + i);
+                acc = _mm256_fmadd_pd(_mm256_loadu_pd(a0 + i), v0, acc);
+                acc = _mm256_fmadd_pd(_mm256_loadu_pd(a1 + i), v1, acc);
+                acc = _mm256_fmadd_pd(_mm256_loadu_pd(a2 + i), v2, acc);
+                acc = _mm256_fmadd_pd(_mm256_loadu_pd(a3 + i), v3, acc);
+                _mm256_storeu_pd(yb + i, acc);
+            }
+            for (; i<rows; ++i) {
+                yb[i] += c0*a0[i] + c1*a1[i] + c2*a2[i] + c3*a3[i];
+            }
+        }
+        for (; j<n; ++j) {
+            const double* a0 = a + i0 + j*lda;
+            const double c0 = alpha*x[j];
+            const __m256d v0 = _mm256_set1_pd(c0);
+            std::size_t i = 0;
+            for (; i+4<=rows; i+=4) {
+                _mm256_storeu_pd(yb + i,
+                    _mm256_fmadd_pd(_mm256_loadu_pd(a0 + i), v0, _mm256_loadu_pd(yb + i)));
+            }
+            for (; i<rows; ++i) {
+                yb[i] += c0*a0[i];
+            }
+        }
+    }
+}
+
+// AVX-512: 8 doubles per register, the tails are masked loads
+// through memory: the shuffle intrinsics trigger -Wmaybe-uninitialized
+// in the headers of gcc 12
+__attribute__((target("avx512f")))
+inline double hsum_avx512(__m512d v) {
+    alignas(64) double t[8];
+    _mm512_store_pd(t, v);
+    return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+}
+
+__attribute__((target("avx512f")))
+inline __mmask8 tail_mask(std::size_t remaining) {
+    return static_cast<__mmask8>((1u << remaining) - 1);
+}
+
+__attribute__((target("avx512f")))
+void gemv_rows_avx512(const double* a, std::size_t lda, std::size_t m, std::size_t n,
+    double alpha, const double* x, double beta, double* y) {
+    const std::size_t body = n / 8 * 8;
+    const __mmask8 k = tail_mask(n - body);
+    std::size_t i = 0;
+    for (; i+4<=m; i+=4) {
+        const double* a0 = a + i*lda;
+        const double* a1 = a0 + lda;
+        const double* a2 = a1 + lda;
+        const double* a3 = a2 + lda;
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        __m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+        for (std::size_t j=0; j<body; j+=8) {
+            const __m512d xv = _mm512_loadu_pd(x + j);
+            s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a0 + j), xv, s0);
+            s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a1 + j), xv, s1);
+            s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a2 + j), xv, s2);
+            s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a3 + j), xv, s3);
+        }
+        if (k != 0) {
+            const __m512d xv = _mm512_maskz_loadu_pd(k, x + body);
+            s0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a0 + body), xv, s0);
+            s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a1 + body), xv, s1);
+            s2 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a2 + body), xv, s2);
+            s3 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a3 + body), xv, s3);
+        }
+        y[i] = finish(hsum_avx512(s0), alpha, beta, y[i]);
+        y[i+1] = finish(hsum_avx512(s1), alpha, beta, y[i+1]);
+        y[i+2] = finish(hsum_avx512(s2), alpha, beta, y[i+2]);
+        y[i+3] = finish(hsum_avx512(s3), alpha, beta, y[i+3]);
+    }
+    for (; i<m; ++i) {
+        const double* a0 = a + i*lda;
+        __m512d s = _mm512_setzero_pd();
+        for (std::size_t j=0; j<body; j+=8) {
+            s = _mm512_fmadd_pd(_mm512_loadu_pd(a0 + j), _mm512_loadu_pd(x + j), s);
+        }
+        s = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a0 + body),
+            _mm512_maskz_loadu_pd(k, x + body), s);
+        y[i] = finish(hsum_avx512(s), alpha, beta, y[i]);
+    }
+}
+
+__attribute__((target("avx512f")))
+void gemv_columns_avx512(const double* a, std::size_t lda, std::size_t m, std::size_t n,
+    double alpha, const double* x, double beta, double* y) {
+    for (std::size_t i0=0; i0<m; i0+=column_block) {
+        const std::size_t rows = std::min(column_block, m - i0);
+        const std::size_t body = rows / 8 * 8;
+        const __mmask8 k = tail_mask(rows - body);
+        double* yb = y + i0;
+        scale_block(beta, yb, rows);
+        std::size_t j = 0;
+        for (; j+4<=n; j+=4) {
+            const double* a0 = a + i0 + j*lda;
+            const double* a1 = a0 + lda;
+            const double* a2 = a1 + lda;
+            const double* a3 = a2 + lda;
+            const __m512d v0 = _mm512_set1_pd(alpha*x[j]), v1 = _mm512_set1_pd(alpha*x[j+1]);
+            const __m512d v2 = _mm512_set1_pd(alpha*x[j+2]), v3 = _mm512_set1_pd(alpha*x[j+3]);
+            for (std::size_t i=0; i<body; i+=8) {
+                __m512d acc = _mm512_loadu_pd(yb + i);
+                acc = _mm512_fmadd_pd(_mm512_loadu_pd(a0 + i), v0, acc);
+                acc = _mm512_fmadd_pd(_mm512_loadu_pd(a1 + i), v1, acc);
+                acc = _mm512_fmadd_pd(_mm512_loadu_pd(a2 + i), v2, acc);
+                acc = _mm512_fmadd_pd(_mm512_loadu_pd(a3 + i), v3, acc);
+                _mm512_storeu_pd(yb + i, acc);
+            }
+            if (k != 0) {
+                __m512d acc = _mm512_maskz_loadu_pd(k, yb + body);
+                acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a0 + body), v0, acc);
+                acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a1 + body), v1, acc);
+                acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a2 + body), v2, acc);
+                acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a3 + body), v3, acc);
+                _mm512_mask_storeu_pd(yb + body, k, acc);
+            }
+        }
+        for (; j<n; ++j) {
+            const double* a0 = a + i0 + j*lda;
+            const __m512d v0 = _mm512_set1_pd(alpha*x[j]);
+            for (std::size_t i=0; i<body; i+=8) {
+                _mm512_storeu_pd(yb + i,
+                    _mm512_fmadd_pd(_mm512_loadu_pd(a0 + i), v0, _mm512_loadu_pd(yb + i)));
+            }
+            if (k != 0) {
+                _mm512_mask_storeu_pd(yb + body, k, _mm512_fmadd_pd(
+                    _mm512_maskz_loadu_pd(k, a0 + body), v0, _mm512_maskz_loadu_pd(k, yb + body)));
+            }
+        }
+    }
+}
+#endif // of #ifdef GEMV_X86
+
+// ############ Runtime dispatch ##############
+struct GemvKernels {
+    const char* name;
+    GemvKernel rows;
+    GemvKernel columns;
+};
+
+// the kernels this cpu can run, best first
+inline std::vector<GemvKernels> supported_kernels() {
+    std::vector<GemvKernels> kernels;
+#ifdef GEMV_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels.push_back({"avx512", gemv_rows_avx512, gemv_columns_avx512});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels.push_back({"avx2", gemv_rows_avx2, gemv_columns_avx2});
+    }
+#endif
+    kernels.push_back({"portable", gemv_rows_portable, gemv_columns_portable});
+    return kernels;
+}
+
+// detected once, on the first call
+inline const GemvKernels& best_kernels() {
+    static const GemvKernels best = supported_kernels().front();
+    return best;
+}
+
+// ############ GEMV ##############
+// elements of A from which on the rows are split between threads
+constexpr std::size_t parallel_threshold = 1 << 16;
+
+// part t of n rows split into parts pieces, at multiples of a cache line of y
+inline std::pair<std::size_t, std::size_t> chunk(std::size_t n, std::size_t parts,
+    std::size_t t) {
+    constexpr std::size_t line = cacheline_size / sizeof(double);
+    auto boundary = [&](std::size_t p) {
+        return p == parts ? n : std::min(n, n * p / parts / line * line);
+    };
+    return {boundary(t), boundary(t + 1)};
+}
+
+// y = alpha*A*x + beta*y; pool == nullptr runs on the calling thread
+inline void gemv(double alpha, MatrixView<const double> A, std::span<const double> x,
+    double beta, std::span<double> y, ForkJoinPool* pool = nullptr,
+    const GemvKernels& kernels = best_kernels()) {
+    const std::size_t m = A.rows();
+    const std::size_t n = A.cols();
+    if (x.size() != n || y.size() != m) {
+        throw std::invalid_argument("gemv: sizes of A, x and y do not match");
+    }
+    // unit stride in one of the dimensions (a single row or column
+    // has both)
+    const bool rows = A.col_stride() == 1 || n == 1;
+    const bool columns = !rows && (A.row_stride() == 1 || m == 1);
+    auto part = [&](std::size_t first, std::size_t last) {
+        if (first == last) {
+            return;
+        }
+        if (rows) {
+            kernels.rows(&A(first, 0), A.row_stride(), last - first, n, alpha,
+                x.data(), beta, y.data() + first);
+        } else if (columns) {
+            kernels.columns(&A(first, 0), A.col_stride(), last - first, n, alpha,
+                x.data(), beta, y.data() + first);
+        } else {
+            for (std::size_t i=first; i<last; ++i) {
+                double s = 0.0;
+                for (std::size_t j=0; j<n; ++j) {
+                    s += A(i, j) * x[j];
+                }
+                y[i] = finish(s, alpha, beta, y[i]);
+            }
+        }
+    };
+    if (n == 0) {
+        scale_block(beta, y.data(), m);
+    } else if (pool == nullptr || pool->size() == 1 || m * n < parallel_threshold) {
+        part(0, m);
+    } else {
+        const std::size_t parts = pool->size();
+        pool->run([&](std::size_t t) {
+            auto [first, last] = chunk(m, parts, t);
+            part(first, last);
+        });
+    }
+}
+
+// not fused: beta*y first, then the product in a second pass
+inline void gemv_reference(double alpha, MatrixView<const double> A,
+    std::span<const double> x, double beta, std::span<double> y) {
+    for (std::size_t i=0; i<A.rows(); ++i) {
+        y[i] = beta == 0.0 ? 0.0 : beta * y[i];
+    }
+    for (std::size_t i=0; i<A.rows(); ++i) {
+        double s = 0.0;
+        for (std::size_t j=0; j<A.cols(); ++j) {
+            s += A(i, j) * x[j];
+        }
+        y[i] += alpha * s;
+    }
+}
+
+// ############ Benchmark ##############
+template <typename F>
+double seconds_per_call(F&& f) {
+    std::size_t runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        f();
+        ++runs;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 0.2);
+    return elapsed.count() / runs;
+}
+
+// the roofline for a matrix that does not fit into the caches: the
+// bandwidth of memcpy over 256 MiB (bytes read plus bytes written,
+// as the STREAM copy benchmark); the library uses the widest loads
+// and stores of the cpu
+double memory_bandwidth() {
+    const std::size_t n = std::size_t{1} << 25;
+    Buffer<double, cacheline_alignment> from(n), to(n);
+    std::fill(from.begin(), from.end(), 1.0);
+    const double t = seconds_per_call([&]() {
+        std::memcpy(to.data(), from.data(), n * sizeof(double));
+    });
+    return 2.0 * n * sizeof(double) / t / 1e9;
+}
+
+struct TestMatrix {
+    std::size_t m;
+    std::size_t n;
+    std::size_t ld;
+    Buffer<double, cacheline_alignment> storage;
+
+    // row-major with a leading dimension padded to a cache line
+    TestMatrix(std::size_t rows, std::size_t cols) :
+        m(rows),
+        n(cols),
+        ld((cols + 7) / 8 * 8),
+        storage(rows * ld) {
+        for (std::size_t i=0; i<m; ++i) {
+            for (std::size_t j=0; j<n; ++j) {
+                storage[i*ld + j] = std::sin(0.01*i + 0.1*j);
+            }
+        }
+    }
+
+    MatrixView<const double> view() const {
+        return MatrixView<const double>(storage.data(), m, n, ld, 1);
+    }
+};
+
+double max_relative_error(std::span<const double> y, std::span<const double> expected) {
+    double error = 0.0;
+    for (std::size_t i=0; i<y.size(); ++i) {
+        error = std::max(error, std::abs(y[i] - expected[i]) / std::max(1.0, std::abs(expected[i])));
+    }
+    return error;
+}
+
+
+int main() {
+    const auto kernels = supported_kernels();
+    std::cout << "kernels on this cpu:";
+    for (const auto& k : kernels) {
+        std::cout << " " << k.name;
+    }
+    std::cout << std::endl;
+
+    ForkJoinPool pool;
+
+    // correctness for odd shapes, both orientations, with and without beta
+    double worst = 0.0;
+    for (std::size_t m : {1, 3, 17, 1029}) {
+        for (std::size_t n : {1, 5, 8, 1031}) {
+            TestMatrix a(m, n);
+            for (bool transposed : {false, true}) {
+                MatrixView<const double> A = transposed ? a.view().transposed() : a.view();
+                std::vector<double> x(A.cols()), y0(A.rows());
+                for (std::size_t j=0; j<x.size(); ++j) x[j] = std::cos(0.3*j);
+                for (std::size_t i=0; i<y0.size(); ++i) y0[i] = 0.5*i;
+                for (double beta : {0.0, 0.7}) {
+                    std::vector<double> expected = y0;
+                    gemv_reference(1.3, A, x, beta, expected);
+                    for (const auto& k : kernels) {
+                        std::vector<double> y = y0;
+                        gemv(1.3, A, x, beta, y, nullptr, k);
+                        worst = std::max(worst, max_relative_error(y, expected));
+                    }
+                    std::vector<double> y = y0;
+                    gemv(1.3, A, x, beta, y, &pool);
+                    worst = std::max(worst, max_relative_error(y, expected));
+                }
+            }
+        }
+    }
+    std::cout << "largest relative error against the reference: " << worst
+        << (worst < 1e-12 ? " (ok)" : " (WRONG)") << std::endl;
+
+    const double roofline = memory_bandwidth();
+    std::cout << "memory bandwidth (roofline): " << std::fixed << std::setprecision(2)
+        << roofline << " GB/s" << std::endl << std::endl;
+
+    std::cout << std::setw(6) << "n" << std::setw(11) << "layout" << std::setw(11) << "kernel"
+        << std::setw(9) << "threads" << std::setw(10) << "GB/s" << std::setw(11) << "roofline"
+        << std::endl;
+    for (std::size_t n : {64, 256, 1024, 4096}) {
+        TestMatrix a(n, n);
+        std::vector<double> x(n, 1.0), y(n, 1.0);
+        // A is read once, x once, y read and written once
+        const double bytes = (n*n + 3.0*n) * sizeof(double);
+        for (bool transposed : {false, true}) {
+            MatrixView<const double> A = transposed ? a.view().transposed() : a.view();
+            const char* layout = transposed ? "columns" : "rows";
+            auto report = [&](const char* kernel, std::size_t threads, double t) {
+                std::cout << std::setw(6) << n << std::setw(11) << layout << std::setw(11) << kernel
+                    << std::setw(9) << threads << std::setw(10) << bytes / t / 1e9
+                    << std::setw(10) << 100.0 * bytes / t / 1e9 / roofline << "%" << std::endl;
+            };
+            report("reference", 1, seconds_per_call([&]() { gemv_reference(0.5, A, x, 0.5, y); }));
+            for (const auto& k : kernels) {
+                report(k.name, 1, seconds_per_call([&]() { gemv(0.5, A, x, 0.5, y, nullptr, k); }));
+            }
+            if (pool.size() > 1) {
+                report(kernels.front().name, pool.size(),
+                    seconds_per_call([&]() { gemv(0.5, A, x, 0.5, y, &pool); }));
+            }
+        }
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
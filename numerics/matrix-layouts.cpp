@@ -0,0 +1,662 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    A dense matrix on top of the Buffer of "../RAII/memory-management.cpp".
+    How element (i, j) is found in memory is a policy given as template
+    parameter:
+        - RowMajor: rows are contiguous, A(i, j) = data[i*ld + j]
+        - ColumnMajor: columns are contiguous, A(i, j) = data[i + j*ld]
+        - Tiled<R, C>: the matrix is cut into tiles of R x C elements,
+          every tile is contiguous (row-major inside) and the tiles
+          are ordered row by row; a kernel working on one tile touches
+          one block of memory instead of R separate rows
+    The leading dimension ld is padded to a multiple of a cache line,
+    so every row (column) starts at an aligned address and can be
+    processed with aligned SIMD loads without a scalar head. The
+    padding elements are zero.
+
+    The layouts carry traits (is_Layout, is_Strided, is_Tiled) like the
+    classes of "../templates/template_specification_with_userdefined_traits.cpp",
+    so functions can be restricted with the 'Require' keyword. The two
+    strided layouts offer MatrixView, a non-owning view with a row and a
+    column stride: submatrices, single rows or columns and the
+    transposed matrix are views without a copy.
+
+    convert() copies between any two layouts (or views). A direct double
+    loop reads one of the matrices across its rows, one element per
+    cache line, and for power-of-two leading dimensions all of these
+    lines fall into the same cache sets. convert() instead halves the
+    larger dimension recursively down to blocks of two cache lines in
+    each direction and copies each block along the destination's
+    lines. Apart from the line size this is cache-oblivious, i.e. fast
+    without knowing the cache sizes. A tiled destination is filled
+    tile by tile, so it is written sequentially. For small matrices,
+    which fit into L2 anyway, there is nothing to gain and both
+    loops run at about the same speed.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <span>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+constexpr std::size_t cacheline_alignment = 64;
+
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Buffer class from memory-management.cpp ##############
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// ############ Definition of helper keywords ##############
+template <typename T, typename... Args>
+using Require = typename std::common_type<T, Args...>::type;
+
+template <typename T>
+using Layout
+    = std::enable_if_t<std::remove_reference<T>::type::is_Layout::value,
+        bool>;
+
+// every element at data[i*row_stride + j*col_stride]
+template <typename T>
+using Strided
+    = std::enable_if_t<std::remove_reference<T>::type::is_Strided::value,
+        bool>;
+
+template <typename T>
+using Tiled
+    = std::enable_if_t<std::remove_reference<T>::type::is_Tiled::value,
+        bool>;
+
+constexpr std::size_t round_up(std::size_t n, std::size_t multiple) {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+// ############ Layouts ##############
+// ld: the distance between two rows (columns), at least cols (rows),
+// rounded up to 'pad' elements
+struct RowMajor {
+    using is_Layout = std::true_type;
+    using is_Strided = std::true_type;
+    using is_Tiled = std::false_type;
+
+    static std::size_t leading(std::size_t, std::size_t cols, std::size_t pad) {
+        return round_up(cols, pad);
+    }
+
+    static std::size_t storage(std::size_t rows, std::size_t, std::size_t ld) {
+        return rows * ld;
+    }
+
+    static std::size_t index(std::size_t i, std::size_t j, std::size_t ld) {
+        return i*ld + j;
+    }
+
+    static std::ptrdiff_t row_stride(std::size_t ld) {
+        return ld;
+    }
+
+    static std::ptrdiff_t col_stride(std::size_t) {
+        return 1;
+    }
+};
+
+struct ColumnMajor {
+    using is_Layout = std::true_type;
+    using is_Strided = std::true_type;
+    using is_Tiled = std::false_type;
+
+    static std::size_t leading(std::size_t rows, std::size_t, std::size_t pad) {
+        return round_up(rows, pad);
+    }
+
+    static std::size_t storage(std::size_t, std::size_t cols, std::size_t ld) {
+        return cols * ld;
+    }
+
+    static std::size_t index(std::size_t i, std::size_t j, std::size_t ld) {
+        return i + j*ld;
+    }
+
+    static std::ptrdiff_t row_stride(std::size_t) {
+        return 1;
+    }
+
+    static std::ptrdiff_t col_stride(std::size_t ld) {
+        return ld;
+    }
+};
+
+// powers of two, so that the divisions in index() become shifts;
+// the rows of a tile stay aligned if C elements fill whole cache lines
+template <std::size_t R = 32, std::size_t C = 32>
+struct TiledLayout {
+    static_assert(R > 0 && (R & (R-1)) == 0 && C > 0 && (C & (C-1)) == 0,
+        "tile sizes must be powers of two");
+
+    using is_Layout = std::true_type;
+    using is_Strided = std::false_type;
+    using is_Tiled = std::true_type;
+
+    static constexpr std::size_t tile_rows = R;
+    static constexpr std::size_t tile_cols = C;
+
+    // the padded number of columns; the rows are padded to R
+    static std::size_t leading(std::size_t, std::size_t cols, std::size_t pad) {
+        return round_up(round_up(cols, C), pad);
+    }
+
+    static std::size_t storage(std::size_t rows, std::size_t, std::size_t ld) {
+        return round_up(rows, R) * ld;
+    }
+
+    // a band of R rows holds ld/C tiles of R*C elements each
+    static std::size_t index(std::size_t i, std::size_t j, std::size_t ld) {
+        return (i / R) * R * ld + (j / C) * R * C + (i % R) * C + (j % C);
+    }
+};
+
+// ############ Strided view ##############
+template <typename T>
+class MatrixView {
+    private:
+        T* data_;
+        std::size_t rows_;
+        std::size_t cols_;
+        std::ptrdiff_t row_stride_;
+        std::ptrdiff_t col_stride_;
+
+    public:
+        using value_type = std::remove_const_t<T>;
+        using is_Layout = std::true_type;
+        using is_Strided = std::true_type;
+        using is_Tiled = std::false_type;
+
+        MatrixView(T* data, std::size_t rows, std::size_t cols,
+            std::ptrdiff_t row_stride, std::ptrdiff_t col_stride) :
+            data_(data),
+            rows_(rows),
+            cols_(cols),
+            row_stride_(row_stride),
+            col_stride_(col_stride) {
+        }
+
+        // a view of non-const elements converts to a const view
+        operator MatrixView<const T>() const {
+            return MatrixView<const T>(data_, rows_, cols_, row_stride_, col_stride_);
+        }
+
+        T& operator() (std::size_t i, std::size_t j) const {
+            return data_[static_cast<std::ptrdiff_t>(i)*row_stride_
+                + static_cast<std::ptrdiff_t>(j)*col_stride_];
+        }
+
+        std::size_t rows() const {
+            return rows_;
+        }
+
+        std::size_t cols() const {
+            return cols_;
+        }
+
+        std::ptrdiff_t row_stride() const {
+            return row_stride_;
+        }
+
+        std::ptrdiff_t col_stride() const {
+            return col_stride_;
+        }
+
+        T* data() const {
+            return data_;
+        }
+
+        MatrixView transposed() const {
+            return MatrixView(data_, cols_, rows_, col_stride_, row_stride_);
+        }
+
+        MatrixView block(std::size_t i, std::size_t j, std::size_t r, std::size_t c) const {
+            if (i + r > rows_ || j + c > cols_) {
+                throw std::out_of_range("block exceeds the matrix");
+            }
+            return MatrixView(&(*this)(i, j), r, c, row_stride_, col_stride_);
+        }
+
+        MatrixView row(std::size_t i) const {
+            return block(i, 0, 1, cols_);
+        }
+
+        MatrixView col(std::size_t j) const {
+            return block(0, j, rows_, 1);
+        }
+};
+
+// ############ Matrix ##############
+template <typename T, typename L = RowMajor, Require< Layout<L> > = true>
+class Matrix {
+    private:
+        // elements per cache line
+        static constexpr std::size_t pad = std::max<std::size_t>(
+            1, cacheline_alignment / sizeof(T));
+
+        std::size_t rows_;
+        std::size_t cols_;
+        std::size_t ld_;
+        Buffer<T, cacheline_alignment> buffer_;
+
+    public:
+        using value_type = T;
+        using layout = L;
+        using is_Layout = std::true_type;
+        using is_Strided = typename L::is_Strided;
+        using is_Tiled = typename L::is_Tiled;
+
+        Matrix(std::size_t rows, std::size_t cols) :
+            rows_(rows),
+            cols_(cols),
+            ld_(L::leading(rows, cols, pad)),
+            buffer_(L::storage(rows, cols, ld_)) {
+        }
+
+        // converts from any other layout or view
+        template <typename Other, Require< Layout<Other> > = true>
+        explicit Matrix(const Other& other) :
+            Matrix(other.rows(), other.cols()) {
+            convert(other, *this);
+        }
+
+        Matrix(Matrix&&) noexcept = default;
+        Matrix& operator=(Matrix&&) noexcept = default;
+
+        T& operator() (std::size_t i, std::size_t j) {
+            return buffer_[L::index(i, j, ld_)];
+        }
+
+        const T& operator() (std::size_t i, std::size_t j) const {
+            return buffer_[L::index(i, j, ld_)];
+        }
+
+        std::size_t rows() const {
+            return rows_;
+        }
+
+        std::size_t cols() const {
+            return cols_;
+        }
+
+        std::size_t leading_dimension() const {
+            return ld_;
+        }
+
+        T* data() {
+            return buffer_.data();
+        }
+
+        const T* data() const {
+            return buffer_.data();
+        }
+
+        // the storage including the padding, for stages that still
+        // work on the raw Buffer
+        Buffer<T, cacheline_alignment>& buffer() {
+            return buffer_;
+        }
+
+        template <typename M = L, Require< Strided<M> > = true>
+        MatrixView<T> view() {
+            return MatrixView<T>(data(), rows_, cols_,
+                M::row_stride(ld_), M::col_stride(ld_));
+        }
+
+        template <typename M = L, Require< Strided<M> > = true>
+        MatrixView<const T> view() const {
+            return MatrixView<const T>(data(), rows_, cols_,
+                M::row_stride(ld_), M::col_stride(ld_));
+        }
+
+        // one tile as a row-major view (the tiles at the border
+        // include padding)
+        template <typename M = L, Require< Tiled<M> > = true>
+        MatrixView<T> tile(std::size_t ti, std::size_t tj) {
+            return MatrixView<T>(&(*this)(ti*M::tile_rows, tj*M::tile_cols),
+                M::tile_rows, M::tile_cols, M::tile_cols, 1);
+        }
+
+        Matrix(const Matrix&) = delete;
+        Matrix& operator=(const Matrix&) = delete;
+};
+
+// ############ Layout conversion ##############
+// true if the elements of a column are next to each other in memory
+// (column-major or a transposed row-major view)
+template <typename M>
+bool column_contiguous(const M& m) {
+    return m.rows() > 1 && &m(1, 0) - &m(0, 0) == 1;
+}
+
+// copies a block of at most two cache lines in each direction (16 x 16
+// doubles, 2 KiB on each side), which stays in L1 while it is copied.
+// The inner loop runs along the lines of the destination, so every
+// destination line is written completely in one go and is not
+// evicted half written
+template <typename Src, typename Dst>
+void convert_leaf(const Src& from, Dst& to, bool by_column,
+    std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1) {
+    if (by_column) {
+        for (std::size_t j=j0; j<j1; ++j) {
+            for (std::size_t i=i0; i<i1; ++i) {
+                to(i, j) = from(i, j);
+            }
+        }
+    } else {
+        for (std::size_t i=i0; i<i1; ++i) {
+            for (std::size_t j=j0; j<j1; ++j) {
+                to(i, j) = from(i, j);
+            }
+        }
+    }
+}
+
+// halves the larger dimension until the block is a leaf
+template <typename Src, typename Dst>
+void convert_block(const Src& from, Dst& to, bool by_column, std::size_t leaf,
+    std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1) {
+    const std::size_t r = i1 - i0;
+    const std::size_t c = j1 - j0;
+    if (r <= leaf && c <= leaf) {
+        convert_leaf(from, to, by_column, i0, i1, j0, j1);
+    } else if (r >= c) {
+        const std::size_t mid = i0 + r/2;
+        convert_block(from, to, by_column, leaf, i0, mid, j0, j1);
+        convert_block(from, to, by_column, leaf, mid, i1, j0, j1);
+    } else {
+        const std::size_t mid = j0 + c/2;
+        convert_block(from, to, by_column, leaf, i0, i1, j0, mid);
+        convert_block(from, to, by_column, leaf, i0, i1, mid, j1);
+    }
+}
+
+// if both sides store their lines in the same direction (e.g. row-major
+// to tiled), a plain loop along these lines is already optimal and the
+// recursion is skipped
+template <typename Src, typename Dst,
+    Require< Layout<Src>, Layout<Dst> > = true>
+void convert(const Src& from, Dst&& to) {
+    if (from.rows() != to.rows() || from.cols() != to.cols()) {
+        throw std::invalid_argument("convert: shapes differ");
+    }
+    using D = std::remove_reference_t<Dst>;
+    using T = typename D::value_type;
+    const bool by_column = column_contiguous(to);
+    if constexpr (D::is_Tiled::value) {
+        // tile by tile, so the destination is written sequentially
+        using L = typename D::layout;
+        for (std::size_t i=0; i<from.rows(); i+=L::tile_rows) {
+            for (std::size_t j=0; j<from.cols(); j+=L::tile_cols) {
+                convert_leaf(from, to, false, i, std::min(i + L::tile_rows, from.rows()),
+                    j, std::min(j + L::tile_cols, from.cols()));
+            }
+        }
+        return;
+    }
+    if (by_column == column_contiguous(from)) {
+        convert_leaf(from, to, by_column, 0, from.rows(), 0, from.cols());
+        return;
+    }
+    const std::size_t leaf = std::max<std::size_t>(1, 2 * cacheline_alignment / sizeof(T));
+    convert_block(from, to, by_column, leaf, 0, from.rows(), 0, from.cols());
+}
+
+// the same with a plain double loop, for comparison
+template <typename Src, typename Dst,
+    Require< Layout<Src>, Layout<Dst> > = true>
+void convert_naive(const Src& from, Dst&& to) {
+    for (std::size_t i=0; i<from.rows(); ++i) {
+        for (std::size_t j=0; j<from.cols(); ++j) {
+            to(i, j) = from(i, j);
+        }
+    }
+}
+
+template <typename A, typename B,
+    Require< Layout<A>, Layout<B> > = true>
+bool equal(const A& a, const B& b) {
+    if (a.rows() != b.rows() || a.cols() != b.cols()) {
+        return false;
+    }
+    for (std::size_t i=0; i<a.rows(); ++i) {
+        for (std::size_t j=0; j<a.cols(); ++j) {
+            if (a(i, j) != b(i, j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ############ Benchmark ##############
+template <typename F>
+double gigabytes_per_second(std::size_t bytes, F&& f) {
+    int runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        f();
+        ++runs;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 0.2);
+    return bytes * runs / elapsed.count() / 1e9;
+}
+
+template <typename Dst>
+void benchmark(const char* name, const Matrix<double>& a) {
+    Dst b(a.rows(), a.cols());
+    // read and written once
+    const std::size_t bytes = 2 * a.rows() * a.cols() * sizeof(double);
+    const double naive = gigabytes_per_second(bytes, [&]() { convert_naive(a, b); });
+    const double oblivious = gigabytes_per_second(bytes, [&]() { convert(a, b); });
+    std::cout << std::setw(14) << name << std::setw(7) << a.rows()
+        << std::fixed << std::setprecision(2)
+        << std::setw(12) << naive << std::setw(16) << oblivious
+        << std::setw(8) << (equal(a, b) ? "ok" : "WRONG") << std::endl;
+}
+
+
+int main() {
+    // layouts and padding
+    Matrix<double> r(5, 7);
+    Matrix<double, ColumnMajor> c(5, 7);
+    Matrix<float, TiledLayout<8, 16>> t(5, 7);
+    for (std::size_t i=0; i<r.rows(); ++i) {
+        for (std::size_t j=0; j<r.cols(); ++j) {
+            r(i, j) = 10.0*i + j;
+        }
+    }
+    convert(r, c);
+    convert(r, t);
+    std::cout << "5 x 7 matrix, leading dimension / elements stored:" << std::endl
+        << "  row-major double:    " << r.leading_dimension() << " / " << r.buffer().size() << std::endl
+        << "  column-major double: " << c.leading_dimension() << " / " << c.buffer().size() << std::endl
+        << "  tiled 8 x 16 float:  " << t.leading_dimension() << " / " << t.buffer().size() << std::endl;
+    std::cout << "row 3 aligned to a cache line: " << std::boolalpha
+        << (reinterpret_cast<std::uintptr_t>(&r(3, 0)) % cacheline_alignment == 0) << std::endl;
+
+    // views share the storage
+    MatrixView<double> v = r.view().block(1, 2, 3, 4).transposed();
+    v(0, 1) = -1.0;
+    std::cout << "block(1, 2, 3, 4).transposed() is " << v.rows() << " x " << v.cols()
+        << ", writing (0, 1) changes r(2, 2) to " << r(2, 2) << std::endl;
+    std::cout << "column 4 of the column-major copy: ";
+    for (std::size_t i=0; i<c.rows(); ++i) {
+        std::cout << c.view().col(4)(i, 0) << " ";
+    }
+    std::cout << std::endl << "tile (0, 0) of the tiled copy, element (4, 6): "
+        << t.tile(0, 0)(4, 6) << std::endl;
+    std::cout << "tiled copy equals the column-major copy: " << equal(t, c)
+        << std::endl << std::endl;
+
+    // conversion of a row-major matrix; 2048 has a power-of-two
+    // leading dimension
+    std::cout << std::setw(14) << "to" << std::setw(7) << "n"
+        << std::setw(12) << "naive GB/s" << std::setw(16) << "oblivious GB/s"
+        << std::setw(8) << "check" << std::endl;
+    for (std::size_t n : {500, 2000, 2048}) {
+        Matrix<double> a(n, n);
+        for (std::size_t i=0; i<n; ++i) {
+            for (std::size_t j=0; j<n; ++j) {
+                a(i, j) = static_cast<double>(i*n + j);
+            }
+        }
+        benchmark<Matrix<double, ColumnMajor>>("column-major", a);
+        benchmark<Matrix<double, TiledLayout<>>>("tiled 32 x 32", a);
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
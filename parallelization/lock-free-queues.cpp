@@ -0,0 +1,766 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    Producer/consumer stages usually talk through a queue. A std::deque
+    behind a mutex and a condition variable is easy to get right, but
+    every message takes the mutex twice and often wakes a thread via
+    a system call. For small messages this overhead dominates. This
+    file adds two bounded queues without locks:
+        - MpmcQueue (Dmitry Vyukov's bounded MPMC queue): any number of
+          producers and consumers. Every slot has a sequence number
+          that says whether the slot is free for the producer of a
+          certain round or filled for the consumer of that round, so
+          producers and consumers only contend on the index they
+          advance (one CAS per message, or per batch).
+        - SpscRing: exactly one producer and one consumer. No CAS at
+          all, both sides only write their own index, and each side
+          keeps a cached copy of the other index, so it only reads the
+          other cache line when the ring seems full (or empty).
+          Every operation finishes in a bounded number of steps
+          (wait-free).
+    Both have batch functions, which move several messages for the
+    cost of a single index update.
+    The indices are on separate cache lines, otherwise producers and
+    consumers would invalidate each other's cache line all the time
+    (false sharing).
+    The queues do not block: try_push/try_pop return false if the
+    queue is full/empty, and the caller decides whether to spin,
+    yield or sleep.
+
+    The main function sends small messages through all queues and
+    compares them with a Lock<std::mutex> + condition variable queue.
+*/
+
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <string>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// ############ Tracing policies ##############
+// A policy performs the locking and unlocking of the resource and
+// may record something around it:
+//     lock(r)    acquires r (blocking)
+//     unlock(r)  releases r
+//     locked(r)  r was acquired by try_lock, a timed lock or adopted
+// The Lock derives from its policy, so a policy may keep state per
+// Lock object, and an empty policy does not take any space.
+
+// the default policy does nothing else and is optimized away completely
+struct NoTracing {
+    template <typename T>
+    void lock(T& r) {
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+    }
+
+    template <typename T>
+    void locked(T&) {
+    }
+};
+
+
+// Lock without I/O; [[nodiscard]] at the constructors makes the
+// compiler warn about "Lock<std::mutex>{m};", which unlocks again
+// immediately (the attribute at the class covers functions that
+// return a Lock)
+template <typename T, typename Tracing = NoTracing>
+class [[nodiscard]] Lock : private Tracing {
+    private:
+        // a pointer instead of a reference, as a moved-from
+        // Lock does not refer to any resource
+        T* resource;
+        bool owns;
+
+    public:
+        // constructor locks the resource
+        [[nodiscard]] explicit Lock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        // only stores the resource, lock() is called later
+        Lock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        // does not block, check owns_lock() afterwards
+        [[nodiscard]] Lock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        // the resource is already locked by the calling thread
+        Lock(T& r, std::adopt_lock_t) : resource(&r), owns(true) {
+            Tracing::locked(*resource);
+        }
+
+        // waits at most for the given time (e.g. std::timed_mutex)
+        template <typename Rep, typename Period>
+        [[nodiscard]] Lock(T& r, const std::chrono::duration<Rep, Period>& timeout) :
+            resource(&r), owns(false) {
+            (void)try_lock_for(timeout);
+        }
+
+        // waits at most until the given point in time
+        template <typename Clock, typename Duration>
+        [[nodiscard]] Lock(T& r, const std::chrono::time_point<Clock, Duration>& deadline) :
+            resource(&r), owns(false) {
+            (void)try_lock_until(deadline);
+        }
+
+        // destructor releases the resource if it is owned
+        ~Lock() {
+            if (owns) {
+                unlock();
+            }
+        }
+
+        // the ownership can be passed on, but not copied
+        Lock(Lock&& other) noexcept :
+            Tracing(std::move(static_cast<Tracing&>(other))),
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        Lock& operator=(Lock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    unlock();
+                }
+                static_cast<Tracing&>(*this) = std::move(static_cast<Tracing&>(other));
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        // same errors as std::unique_lock
+        void lock() {
+            check();
+            Tracing::lock(*resource);
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock();
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+            check();
+            owns = resource->try_lock_for(timeout);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Clock, typename Duration>
+        [[nodiscard]] bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+            check();
+            owns = resource->try_lock_until(deadline);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            Tracing::unlock(*resource);
+        }
+
+        // gives up the ownership without unlocking
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// ############ Queues ##############
+constexpr std::size_t cacheline_size = 64;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+inline std::size_t round_up_power_of_two(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) {
+        p *= 2;
+    }
+    return p;
+}
+
+// uninitialized storage for one T
+template <typename T>
+struct Storage {
+    alignas(T) unsigned char bytes[sizeof(T)];
+
+    T* get() {
+        return std::launder(reinterpret_cast<T*>(bytes));
+    }
+};
+
+// Bounded multi-producer multi-consumer queue. The slot for position
+// pos has the sequence number
+//     pos          free for the producer of pos
+//     pos + 1      filled for the consumer of pos
+// and the consumer sets it to pos + capacity for the next round.
+// Once a producer has claimed a slot it must publish it, otherwise
+// all consumers behind it wait forever; so a T that may throw while
+// it is constructed is built before the slot is claimed and then
+// moved in.
+template <typename T>
+class MpmcQueue {
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+        "T is moved in and out of the queue after the slot was claimed");
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            Storage<T> value;
+        };
+
+        const std::size_t mask;
+        std::unique_ptr<Cell[]> cells;
+        alignas(cacheline_size) std::atomic<std::size_t> enqueue_pos{0};
+        alignas(cacheline_size) std::atomic<std::size_t> dequeue_pos{0};
+        // keeps the next member away from dequeue_pos
+        char padding[cacheline_size - sizeof(std::atomic<std::size_t>)];
+
+        // number of consecutive slots from pos on that have the
+        // sequence number pos + i + offset, at most n
+        std::size_t ready(std::size_t pos, std::size_t offset, std::size_t n) const {
+            std::size_t k = 0;
+            while (k < n && cells[(pos + k) & mask].sequence.load(
+                std::memory_order_acquire) == pos + k + offset) {
+                ++k;
+            }
+            return k;
+        }
+
+        // claims up to n positions of index; offset 0 for producers,
+        // 1 for consumers; returns the first position and the count
+        std::pair<std::size_t, std::size_t> claim(std::atomic<std::size_t>& index,
+            std::size_t offset, std::size_t n) {
+            std::size_t pos = index.load(std::memory_order_relaxed);
+            for (;;) {
+                const std::size_t k = ready(pos, offset, n);
+                if (k == 0) {
+                    const std::size_t seq = cells[pos & mask].sequence.load(
+                        std::memory_order_acquire);
+                    if (static_cast<std::ptrdiff_t>(seq - (pos + offset)) < 0) {
+                        // full (producer) or empty (consumer)
+                        return {pos, 0};
+                    }
+                    // another thread was faster
+                    pos = index.load(std::memory_order_relaxed);
+                } else if (index.compare_exchange_weak(pos, pos + k,
+                    std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    return {pos, k};
+                }
+            }
+        }
+
+    public:
+        // the capacity is rounded up to a power of two
+        explicit MpmcQueue(std::size_t capacity) :
+            mask(round_up_power_of_two(std::max<std::size_t>(capacity, 2)) - 1),
+            cells(new Cell[mask + 1]) {
+            for (std::size_t i=0; i<=mask; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // no other thread uses the queue any more, so every slot
+        // between the two indices is filled
+        ~MpmcQueue() {
+            const std::size_t end = enqueue_pos.load(std::memory_order_relaxed);
+            for (std::size_t pos=dequeue_pos.load(std::memory_order_relaxed); pos!=end; ++pos) {
+                cells[pos & mask].value.get()->~T();
+            }
+        }
+
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        std::size_t capacity() const {
+            return mask + 1;
+        }
+
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            if constexpr (!std::is_nothrow_constructible<T, Args&&...>::value) {
+                T item(std::forward<Args>(args)...);
+                return try_emplace(std::move(item));
+            } else {
+                auto [pos, k] = claim(enqueue_pos, 0, 1);
+                if (k == 0) {
+                    return false;
+                }
+                Cell& c = cells[pos & mask];
+                new (c.value.bytes) T(std::forward<Args>(args)...);
+                c.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+
+        bool try_push(T item) {
+            return try_emplace(std::move(item));
+        }
+
+        bool try_pop(T& item) {
+            auto [pos, k] = claim(dequeue_pos, 1, 1);
+            if (k == 0) {
+                return false;
+            }
+            Cell& c = cells[pos & mask];
+            item = std::move(*c.value.get());
+            c.value.get()->~T();
+            c.sequence.store(pos + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        // pushes up to n items from first on; returns how many
+        // (one by one if copying an item may throw)
+        template <typename InputIt>
+        std::size_t try_push_batch(InputIt first, std::size_t n) {
+            if constexpr (!std::is_nothrow_constructible<T, decltype(*first)>::value) {
+                std::size_t k = 0;
+                for (; k<n && try_emplace(*first); ++k, ++first) {
+                }
+                return k;
+            } else {
+                auto [pos, k] = claim(enqueue_pos, 0, n);
+                for (std::size_t i=0; i<k; ++i, ++first) {
+                    Cell& c = cells[(pos + i) & mask];
+                    new (c.value.bytes) T(*first);
+                    c.sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                return k;
+            }
+        }
+
+        // pops up to n items to out; returns how many
+        template <typename OutputIt>
+        std::size_t try_pop_batch(OutputIt out, std::size_t n) {
+            auto [pos, k] = claim(dequeue_pos, 1, n);
+            for (std::size_t i=0; i<k; ++i, ++out) {
+                Cell& c = cells[(pos + i) & mask];
+                *out = std::move(*c.value.get());
+                c.value.get()->~T();
+                c.sequence.store(pos + i + mask + 1, std::memory_order_release);
+            }
+            return k;
+        }
+};
+
+// Single-producer single-consumer ring. Only the producer writes
+// tail, only the consumer writes head; the cached copies are only
+// used by the owner of the cache line they are on.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+        "T is moved in and out of the ring");
+
+    private:
+        const std::size_t mask;
+        std::unique_ptr<Storage<T>[]> slots;
+        // producer's cache line
+        alignas(cacheline_size) std::atomic<std::size_t> tail{0};
+        std::size_t cached_head = 0;
+        // consumer's cache line
+        alignas(cacheline_size) std::atomic<std::size_t> head{0};
+        std::size_t cached_tail = 0;
+        char padding[cacheline_size - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+
+        // free slots for the producer; reads head only if
+        // the cached value is not good enough
+        std::size_t free_slots(std::size_t t, std::size_t wanted) {
+            std::size_t n = mask + 1 - (t - cached_head);
+            if (n < wanted) {
+                cached_head = head.load(std::memory_order_acquire);
+                n = mask + 1 - (t - cached_head);
+            }
+            return n;
+        }
+
+        std::size_t filled_slots(std::size_t h, std::size_t wanted) {
+            std::size_t n = cached_tail - h;
+            if (n < wanted) {
+                cached_tail = tail.load(std::memory_order_acquire);
+                n = cached_tail - h;
+            }
+            return n;
+        }
+
+    public:
+        explicit SpscRing(std::size_t capacity) :
+            mask(round_up_power_of_two(std::max<std::size_t>(capacity, 2)) - 1),
+            slots(new Storage<T>[mask + 1]) {
+        }
+
+        ~SpscRing() {
+            const std::size_t t = tail.load(std::memory_order_relaxed);
+            for (std::size_t h=head.load(std::memory_order_relaxed); h!=t; ++h) {
+                slots[h & mask].get()->~T();
+            }
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        std::size_t capacity() const {
+            return mask + 1;
+        }
+
+        // only called by the producer; if the constructor of T
+        // throws, tail is not advanced and the slot stays free
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            const std::size_t t = tail.load(std::memory_order_relaxed);
+            if (free_slots(t, 1) == 0) {
+                return false;
+            }
+            new (slots[t & mask].bytes) T(std::forward<Args>(args)...);
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(T item) {
+            return try_emplace(std::move(item));
+        }
+
+        template <typename InputIt>
+        std::size_t try_push_batch(InputIt first, std::size_t n) {
+            const std::size_t t = tail.load(std::memory_order_relaxed);
+            const std::size_t k = std::min(n, free_slots(t, n));
+            std::size_t i = 0;
+            try {
+                for (; i<k; ++i, ++first) {
+                    new (slots[(t + i) & mask].bytes) T(*first);
+                }
+            } catch (...) {
+                // the items built so far are published
+                tail.store(t + i, std::memory_order_release);
+                throw;
+            }
+            tail.store(t + k, std::memory_order_release);
+            return k;
+        }
+
+        // only called by the consumer
+        bool try_pop(T& item) {
+            const std::size_t h = head.load(std::memory_order_relaxed);
+            if (filled_slots(h, 1) == 0) {
+                return false;
+            }
+            T* p = slots[h & mask].get();
+            item = std::move(*p);
+            p->~T();
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        template <typename OutputIt>
+        std::size_t try_pop_batch(OutputIt out, std::size_t n) {
+            const std::size_t h = head.load(std::memory_order_relaxed);
+            const std::size_t k = std::min(n, filled_slots(h, n));
+            for (std::size_t i=0; i<k; ++i, ++out) {
+                T* p = slots[(h + i) & mask].get();
+                *out = std::move(*p);
+                p->~T();
+            }
+            head.store(h + k, std::memory_order_release);
+            return k;
+        }
+};
+
+// ############ Benchmark ##############
+// the classic bounded queue; push and pop block. The Lock is
+// BasicLockable, so it works with std::condition_variable_any
+template <typename T>
+class LockedQueue {
+    private:
+        std::mutex m;
+        std::condition_variable_any not_empty;
+        std::condition_variable_any not_full;
+        std::deque<T> items;
+        const std::size_t limit;
+
+    public:
+        explicit LockedQueue(std::size_t capacity) : limit(capacity) {
+        }
+
+        template <typename InputIt>
+        void push_batch(InputIt first, std::size_t n) {
+            for (std::size_t i=0; i<n; ) {
+                Lock<std::mutex> lock(m);
+                not_full.wait(lock, [this]() { return items.size() < limit; });
+                for (; i<n && items.size() < limit; ++i, ++first) {
+                    items.push_back(*first);
+                }
+                lock.unlock();
+                not_empty.notify_all();
+            }
+        }
+
+        void push(T item) {
+            push_batch(&item, 1);
+        }
+
+        template <typename OutputIt>
+        std::size_t pop_batch(OutputIt out, std::size_t n) {
+            std::size_t k = 0;
+            {
+                Lock<std::mutex> lock(m);
+                not_empty.wait(lock, [this]() { return !items.empty(); });
+                for (; k<n && !items.empty(); ++k, ++out) {
+                    *out = std::move(items.front());
+                    items.pop_front();
+                }
+            }
+            not_full.notify_all();
+            return k;
+        }
+
+        T pop() {
+            T item;
+            pop_batch(&item, 1);
+            return item;
+        }
+};
+
+// blocking send/receive on top of the different queues; the
+// lock-free queues spin, yielding the cpu after a while
+template <typename Queue>
+void send(Queue& q, const std::uint64_t* items, std::size_t n, std::size_t batch) {
+    unsigned rounds = 0;
+    for (std::size_t i=0; i<n; ) {
+        const std::size_t k = batch == 1
+            ? std::size_t(q.try_push(items[i]))
+            : q.try_push_batch(items + i, std::min(batch, n - i));
+        if (k == 0) {
+            if (++rounds < 64) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        } else {
+            rounds = 0;
+        }
+        i += k;
+    }
+}
+
+template <typename Queue>
+std::size_t receive(Queue& q, std::uint64_t* out, std::size_t n, std::size_t batch) {
+    unsigned rounds = 0;
+    for (;;) {
+        const std::size_t k = batch == 1
+            ? std::size_t(q.try_pop(*out))
+            : q.try_pop_batch(out, std::min(batch, n));
+        if (k > 0) {
+            return k;
+        }
+        if (++rounds < 64) {
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void send(LockedQueue<std::uint64_t>& q, const std::uint64_t* items,
+    std::size_t n, std::size_t batch) {
+    for (std::size_t i=0; i<n; i+=batch) {
+        q.push_batch(items + i, std::min(batch, n - i));
+    }
+}
+
+std::size_t receive(LockedQueue<std::uint64_t>& q, std::uint64_t* out,
+    std::size_t n, std::size_t batch) {
+    return q.pop_batch(out, std::min(batch, n));
+}
+
+constexpr std::size_t message_count = 1 << 22;
+constexpr std::size_t queue_capacity = 1024;
+
+// the producers send the numbers 0 .. message_count-1, the consumers
+// add them up; returns million messages per second
+template <typename Queue>
+double run(std::size_t producers, std::size_t consumers, std::size_t batch) {
+    Queue q(queue_capacity);
+    std::vector<std::uint64_t> messages(message_count);
+    for (std::size_t i=0; i<message_count; ++i) {
+        messages[i] = i;
+    }
+    std::atomic<std::uint64_t> total{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t p=0; p<producers; ++p) {
+        threads.emplace_back([&, p]() {
+            const std::size_t first = message_count * p / producers;
+            const std::size_t last = message_count * (p + 1) / producers;
+            send(q, messages.data() + first, last - first, batch);
+        });
+    }
+    for (std::size_t c=0; c<consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            std::size_t remaining = message_count * (c + 1) / consumers
+                - message_count * c / consumers;
+            std::vector<std::uint64_t> buffer(batch);
+            std::uint64_t sum = 0;
+            while (remaining > 0) {
+                const std::size_t k = receive(q, buffer.data(),
+                    std::min(batch, remaining), batch);
+                for (std::size_t i=0; i<k; ++i) {
+                    sum += buffer[i];
+                }
+                remaining -= k;
+            }
+            total.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    if (total.load() != std::uint64_t(message_count) * (message_count - 1) / 2) {
+        std::cout << "lost messages!" << std::endl;
+    }
+    return message_count / dt.count() / 1e6;
+}
+
+
+int main() {
+    MpmcQueue<std::string> strings(4);
+    (void)strings.try_push("first");
+    (void)strings.try_emplace(3, 'x');
+    std::string s;
+    while (strings.try_pop(s)) {
+        std::cout << "popped " << s << std::endl;
+    }
+
+    using Locked = LockedQueue<std::uint64_t>;
+    using Mpmc = MpmcQueue<std::uint64_t>;
+    using Spsc = SpscRing<std::uint64_t>;
+
+    std::size_t pairs = std::thread::hardware_concurrency() / 2;
+    if (pairs < 1) {
+        pairs = 1;
+    }
+
+    std::cout << "million messages per second, " << message_count << " messages, capacity "
+        << queue_capacity << " (" << std::thread::hardware_concurrency() << " cores)"
+        << std::endl;
+    std::cout << std::setw(22) << "producers/consumers" << std::setw(7) << "batch"
+        << std::setw(15) << "Lock + condvar" << std::setw(11) << "MpmcQueue"
+        << std::setw(10) << "SpscRing" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (std::size_t batch : {1, 64}) {
+        std::cout << std::setw(22) << "1/1" << std::setw(7) << batch
+            << std::setw(15) << run<Locked>(1, 1, batch)
+            << std::setw(11) << run<Mpmc>(1, 1, batch)
+            << std::setw(10) << run<Spsc>(1, 1, batch) << std::endl;
+    }
+    if (pairs > 1) {
+        const std::string label = std::to_string(pairs) + "/" + std::to_string(pairs);
+        for (std::size_t batch : {1, 64}) {
+            std::cout << std::setw(22) << label << std::setw(7) << batch
+                << std::setw(15) << run<Locked>(pairs, pairs, batch)
+                << std::setw(11) << run<Mpmc>(pairs, pairs, batch)
+                << std::setw(10) << "-" << std::endl;
+        }
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
@@ -0,0 +1,566 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    The same kernels (fill, transform, reduce over a Buffer) on three
+    backends:
+        - Serial: plain loops
+        - Threads: a fork-join pool of std::threads that stay alive
+          between the calls; every thread gets one contiguous chunk
+        - OpenMP: "#pragma omp parallel for simd"
+    The backend is a policy object passed as first argument. The
+    kernels are selected with the 'Require' keyword and the traits of
+    "../templates/template_specification_with_userdefined_traits.cpp":
+    every backend defines is_Backend and one of is_Serial, is_Threads
+    or is_OpenMP. with_backend() picks one of them at runtime by name,
+    the kernel code is instantiated for each of them.
+
+    OpenMP is detected through the _OPENMP macro, which the compiler
+    defines with -fopenmp. Without it, the OpenMP backend declares
+    itself as serial, so the serial kernels are used and the program
+    still compiles and runs:
+        g++ -std=c++20 -O3 -march=native -fopenmp -pthread openmp-backends.cpp
+        g++ -std=c++20 -O3 -march=native -pthread openmp-backends.cpp
+    Below parallel_threshold elements the parallel backends stay
+    serial, as starting the threads would cost more than the work.
+
+    The main function compares the backends for sizes from a few
+    kilobytes (in cache) to tens of megabytes (in memory).
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <span>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+constexpr std::size_t cacheline_alignment = 64;
+
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Buffer class from memory-management.cpp ##############
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// ############ Definition of helper keywords ##############
+// define 'Require' keyword
+template <typename T, typename... Args>
+using Require = typename std::common_type<T, Args...>::type;
+
+// keywords for the traits of the backends
+template <typename T>
+using Backend
+    = std::enable_if_t<std::remove_reference<T>::type::is_Backend::value,
+        bool>;
+
+template <typename T>
+using SerialBackend
+    = std::enable_if_t<std::remove_reference<T>::type::is_Serial::value,
+        bool>;
+
+template <typename T>
+using ThreadsBackend
+    = std::enable_if_t<std::remove_reference<T>::type::is_Threads::value,
+        bool>;
+
+template <typename T>
+using OpenMPBackend
+    = std::enable_if_t<std::remove_reference<T>::type::is_OpenMP::value,
+        bool>;
+
+// ############ Fork-join pool ##############
+constexpr std::size_t cacheline_size = 64;
+
+// below this number of elements the kernels run serially
+constexpr std::size_t parallel_threshold = 1 << 15;
+
+// part t of n elements split into parts pieces
+inline std::pair<std::size_t, std::size_t> chunk(std::size_t n, std::size_t parts,
+    std::size_t t) {
+    return {n * t / parts, n * (t + 1) / parts};
+}
+
+// Runs a function on all threads at once and waits for all of them.
+// The calling thread takes part 0, so the pool starts size()-1
+// threads. Waiting threads sleep on an atomic (futex). Not reentrant:
+// a job must not call run() itself.
+class ForkJoinPool {
+    private:
+        std::vector<std::thread> threads;
+        std::function<void(std::size_t)> job;
+        alignas(cacheline_size) std::atomic<std::uint32_t> generation{0};
+        alignas(cacheline_size) std::atomic<std::size_t> pending{0};
+        std::atomic<bool> stopping{false};
+
+        void work(std::size_t index) {
+            std::uint32_t seen = 0;
+            for (;;) {
+                generation.wait(seen, std::memory_order_acquire);
+                seen = generation.load(std::memory_order_acquire);
+                if (stopping.load(std::memory_order_acquire)) {
+                    return;
+                }
+                job(index);
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pending.notify_one();
+                }
+            }
+        }
+
+    public:
+        explicit ForkJoinPool(std::size_t n = std::thread::hardware_concurrency()) {
+            for (std::size_t i=1; i<std::max<std::size_t>(n, 1); ++i) {
+                threads.emplace_back(&ForkJoinPool::work, this, i);
+            }
+        }
+
+        ~ForkJoinPool() {
+            stopping.store(true, std::memory_order_release);
+            generation.fetch_add(1, std::memory_order_release);
+            generation.notify_all();
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+
+        ForkJoinPool(const ForkJoinPool&) = delete;
+        ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+        std::size_t size() const {
+            return threads.size() + 1;
+        }
+
+        // calls f(t) for t = 0 .. size()-1 in parallel
+        template <typename F>
+        void run(F&& f) {
+            job = std::ref(f);
+            pending.store(threads.size(), std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            generation.notify_all();
+            f(0);
+            std::size_t p;
+            while ((p = pending.load(std::memory_order_acquire)) != 0) {
+                pending.wait(p, std::memory_order_acquire);
+            }
+        }
+};
+
+// ############ Definition of backends ##############
+class Serial {
+    public:
+        using is_Backend = std::true_type;
+        using is_Serial = std::true_type;
+};
+
+class Threads {
+    private:
+        ForkJoinPool pool;
+
+    public:
+        using is_Backend = std::true_type;
+        using is_Threads = std::true_type;
+
+        explicit Threads(std::size_t n = std::thread::hardware_concurrency()) : pool(n) {
+        }
+
+        std::size_t size() const {
+            return pool.size();
+        }
+
+        // calls f(t, first, last) with one chunk of n per thread
+        template <typename F>
+        void for_chunks(std::size_t n, F f) {
+            const std::size_t parts = pool.size();
+            pool.run([&](std::size_t t) {
+                auto [first, last] = chunk(n, parts, t);
+                f(t, first, last);
+            });
+        }
+};
+
+class OpenMP {
+    public:
+        using is_Backend = std::true_type;
+#ifdef _OPENMP
+        using is_OpenMP = std::true_type;
+#else
+        // compiled without -fopenmp: use the serial kernels
+        using is_Serial = std::true_type;
+#endif
+};
+
+// partial result of a reduction on its own cache line
+template <typename T>
+struct alignas(cacheline_size) Padded {
+    T value;
+};
+
+// ############ Definition of kernels ##############
+// serial
+template <class B, typename T, std::size_t A,
+    Require< SerialBackend<B> > = true>
+void fill(B&, Buffer<T, A>& b, const T& value) {
+    std::fill(b.begin(), b.end(), value);
+}
+
+template <class B, typename T, std::size_t A, typename U, std::size_t C, typename F,
+    Require< SerialBackend<B> > = true>
+void transform(B&, const Buffer<T, A>& in, Buffer<U, C>& out, F f) {
+    std::transform(in.begin(), in.end(), out.begin(), f);
+}
+
+template <class B, typename T, std::size_t A, typename R, typename Op,
+    Require< SerialBackend<B> > = true>
+R reduce(B&, const Buffer<T, A>& b, R identity, Op op) {
+    R acc = identity;
+    for (const T& x : b) {
+        acc = op(acc, x);
+    }
+    return acc;
+}
+
+// thread pool
+template <class B, typename T, std::size_t A,
+    Require< ThreadsBackend<B> > = true>
+void fill(B& backend, Buffer<T, A>& b, const T& value) {
+    if (b.size() < parallel_threshold) {
+        Serial serial;
+        fill(serial, b, value);
+        return;
+    }
+    backend.for_chunks(b.size(), [&](std::size_t, std::size_t first, std::size_t last) {
+        std::fill(b.data() + first, b.data() + last, value);
+    });
+}
+
+template <class B, typename T, std::size_t A, typename U, std::size_t C, typename F,
+    Require< ThreadsBackend<B> > = true>
+void transform(B& backend, const Buffer<T, A>& in, Buffer<U, C>& out, F f) {
+    if (in.size() < parallel_threshold) {
+        Serial serial;
+        transform(serial, in, out, f);
+        return;
+    }
+    backend.for_chunks(in.size(), [&](std::size_t, std::size_t first, std::size_t last) {
+        std::transform(in.data() + first, in.data() + last, out.data() + first, f);
+    });
+}
+
+template <class B, typename T, std::size_t A, typename R, typename Op,
+    Require< ThreadsBackend<B> > = true>
+R reduce(B& backend, const Buffer<T, A>& b, R identity, Op op) {
+    if (b.size() < parallel_threshold) {
+        Serial serial;
+        return reduce(serial, b, identity, op);
+    }
+    std::vector<Padded<R>> partials(backend.size(), Padded<R>{identity});
+    backend.for_chunks(b.size(), [&](std::size_t t, std::size_t first, std::size_t last) {
+        R acc = identity;
+        for (std::size_t i=first; i<last; ++i) {
+            acc = op(acc, b[i]);
+        }
+        partials[t].value = acc;
+    });
+    R acc = identity;
+    for (const Padded<R>& p : partials) {
+        acc = op(acc, p.value);
+    }
+    return acc;
+}
+
+#ifdef _OPENMP
+// OpenMP; the if clause keeps small buffers serial
+template <class B, typename T, std::size_t A,
+    Require< OpenMPBackend<B> > = true>
+void fill(B&, Buffer<T, A>& b, const T& value) {
+    T* p = b.data();
+    const std::size_t n = b.size();
+    #pragma omp parallel for simd schedule(static) if(n >= parallel_threshold)
+    for (std::size_t i=0; i<n; ++i) {
+        p[i] = value;
+    }
+}
+
+template <class B, typename T, std::size_t A, typename U, std::size_t C, typename F,
+    Require< OpenMPBackend<B> > = true>
+void transform(B&, const Buffer<T, A>& in, Buffer<U, C>& out, F f) {
+    const T* p = in.data();
+    U* q = out.data();
+    const std::size_t n = in.size();
+    #pragma omp parallel for simd schedule(static) if(n >= parallel_threshold)
+    for (std::size_t i=0; i<n; ++i) {
+        q[i] = f(p[i]);
+    }
+}
+
+// "reduction(op: acc)" only works for the built-in operators
+// (or a declared reduction per type), so the partials are
+// collected by hand
+template <class B, typename T, std::size_t A, typename R, typename Op,
+    Require< OpenMPBackend<B> > = true>
+R reduce(B&, const Buffer<T, A>& b, R identity, Op op) {
+    const T* p = b.data();
+    const std::size_t n = b.size();
+    std::vector<Padded<R>> partials(omp_get_max_threads(), Padded<R>{identity});
+    #pragma omp parallel if(n >= parallel_threshold)
+    {
+        const std::size_t t = omp_get_thread_num();
+        auto [first, last] = chunk(n, omp_get_num_threads(), t);
+        R acc = identity;
+        for (std::size_t i=first; i<last; ++i) {
+            acc = op(acc, p[i]);
+        }
+        partials[t].value = acc;
+    }
+    R acc = identity;
+    for (const Padded<R>& part : partials) {
+        acc = op(acc, part.value);
+    }
+    return acc;
+}
+#endif
+
+// composed of the kernels above, so it works with every backend
+template <class B, typename T, std::size_t A,
+    Require< Backend<B> > = true>
+void scale(B& backend, Buffer<T, A>& b, const T& factor) {
+    transform(backend, b, b, [factor](const T& v) { return factor * v; });
+}
+
+// calls f with the backend of the given name; false for unknown names
+template <typename F>
+bool with_backend(const std::string& name, Threads& threads, F f) {
+    if (name == "serial") {
+        Serial serial;
+        f(serial);
+    } else if (name == "threads") {
+        f(threads);
+    } else if (name == "openmp") {
+        OpenMP openmp;
+        f(openmp);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// ############ Benchmark ##############
+template <typename Func>
+double measure(Func f, std::size_t repetitions) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r=0; r<repetitions; ++r) {
+        f();
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    return dt.count() / repetitions;
+}
+
+
+// usage: ./a.out [serial|threads|openmp]
+int main(int argc, char* argv[]) {
+#ifdef _OPENMP
+    std::cout << "OpenMP " << _OPENMP << " with " << omp_get_max_threads()
+        << " threads" << std::endl;
+#else
+    std::cout << "compiled without OpenMP, the openmp backend is serial" << std::endl;
+#endif
+    Threads threads;
+    std::cout << "thread pool with " << threads.size() << " threads" << std::endl;
+
+    // the backend chosen at runtime runs the same kernel code
+    const std::string name = argc > 1 ? argv[1] : "openmp";
+    const bool known = with_backend(name, threads, [](auto& backend) {
+        Buffer<double> x(1 << 20, uninitialized);
+        Buffer<double> y(x.size(), uninitialized);
+        fill(backend, x, 0.5);
+        transform(backend, x, y, [](double v) { return 2.0 * v; });
+        scale(backend, y, 3.0);
+        std::cout << "sum with the selected backend: "
+            << reduce(backend, y, 0.0, std::plus<>()) << std::endl;
+    });
+    if (!known) {
+        std::cout << "unknown backend " << name << std::endl;
+        return 1;
+    }
+
+    Serial serial;
+    OpenMP openmp;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "GB/s for fill / transform / reduce of doubles" << std::endl;
+    std::cout << std::setw(10) << "elements" << std::setw(24) << "Serial"
+        << std::setw(24) << "Threads" << std::setw(24) << "OpenMP" << std::endl;
+    for (std::size_t n : {1 << 10, 1 << 14, 1 << 18, 1 << 22}) {
+        Buffer<double, cacheline_size> x(n, uninitialized);
+        Buffer<double, cacheline_size> y(n, uninitialized);
+        const std::size_t repetitions = std::max<std::size_t>(10, (1 << 27) / n);
+        const double bytes = n * sizeof(double) / 1e9;
+        volatile double sink = 0;
+        std::cout << std::setw(10) << n;
+        auto columns = [&](auto& backend) {
+            const double f = bytes / measure([&]() { fill(backend, x, 1.0); }, repetitions);
+            const double t = 2 * bytes / measure([&]() {
+                transform(backend, x, y, [](double v) { return 3.0 * v + 1.0; }); }, repetitions);
+            const double r = bytes / measure([&]() {
+                sink = reduce(backend, y, 0.0, std::plus<>()); }, repetitions);
+            std::cout << std::setw(8) << f << std::setw(8) << t << std::setw(8) << r;
+        };
+        columns(serial);
+        columns(threads);
+        columns(openmp);
+        std::cout << std::endl;
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
@@ -0,0 +1,471 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    Aggregation/reduction: combine all elements of a Buffer (or any
+    contiguous range) with an associative operator, e.g. the sum, the
+    product, the maximum. The work is split into one chunk per thread:
+        - every thread reduces its chunk with several independent
+          accumulators ("lanes", one vector register wide), so the
+          additions do not wait for each other and the compiler can
+          use SIMD instructions for arithmetic types
+        - the partial results are kept in slots of a full cache line
+          each; partials next to each other in one array would share
+          cache lines, and every write of one thread would invalidate
+          the line for the others (false sharing)
+        - the partials are combined in a tree: thread i adds the result
+          of thread i + 1, i + 2, i + 4, ... as soon as it is ready,
+          so the combination takes log2(threads) steps
+    Floating point addition is not associative, so the result depends
+    on how the elements are grouped. parallel_reduce only gives the
+    same result for the same number of threads. deterministic_reduce
+    always uses blocks of the same size and combines them in the same
+    order, so it gives the same result for any number of threads.
+    kahan_sum carries the rounding error of every addition along
+    (compensated summation), which makes the result nearly independent
+    of the order. Both only work as long as the compiler does not
+    reorder floating point operations (no -ffast-math).
+
+    The main function compares the scaling with a serial loop:
+        g++ -std=c++20 -O3 -march=native -pthread parallel-reduction.cpp
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <span>
+#include <ranges>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <chrono>
+#include <cmath>
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+constexpr uninitialized_t uninitialized{};
+
+// ############ Buffer class from memory-management.cpp ##############
+template <typename T, std::size_t Alignment = alignof(T)>
+class Buffer {
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than alignof(T)");
+    static_assert((Alignment & (Alignment-1)) == 0,
+        "Alignment must be a power of two");
+
+    private:
+        std::size_t size_;
+        T* data_;
+
+        static T* allocate(std::size_t n) {
+            return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        static void release(T* p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        explicit Buffer(std::size_t s) :
+            size_(s),
+            data_(allocate(size_)) {
+            try {
+                std::uninitialized_value_construct_n(data_, size_);
+            } catch (...) {
+                release(data_);
+                throw;
+            }
+        }
+
+        Buffer(std::size_t s, uninitialized_t) :
+            size_(s),
+            data_(allocate(size_)) {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "uninitialized buffers require a trivial type");
+        }
+
+        ~Buffer() {
+            std::destroy_n(data_, size_);
+            release(data_);
+        }
+
+        Buffer(Buffer&& other) noexcept :
+            size_(std::exchange(other.size_, 0)),
+            data_(std::exchange(other.data_, nullptr)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                std::destroy_n(data_, size_);
+                release(data_);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        T* data() {
+            return data_;
+        }
+
+        const T* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        T& operator[] (size_t i) {
+            return data_[i];
+        }
+
+        const T& operator[] (size_t i) const {
+            return data_[i];
+        }
+
+        iterator begin() {
+            return data_;
+        }
+
+        iterator end() {
+            return data_ + size_;
+        }
+
+        const_iterator begin() const {
+            return data_;
+        }
+
+        const_iterator end() const {
+            return data_ + size_;
+        }
+
+        operator std::span<T>() {
+            return std::span<T>(data_, size_);
+        }
+
+        operator std::span<const T>() const {
+            return std::span<const T>(data_, size_);
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+};
+
+// ############ Reduction ##############
+constexpr std::size_t cacheline_size = 64;
+
+// below this many elements per thread, starting a thread costs
+// more than it saves
+constexpr std::size_t min_chunk = 1 << 14;
+
+// elements per block of deterministic_reduce
+constexpr std::size_t deterministic_block = 1 << 12;
+
+inline std::size_t default_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// number of independent accumulators: a 64 byte vector (AVX-512)
+// for arithmetic types, one for everything else
+template <typename E>
+constexpr std::size_t lanes_for() {
+    if constexpr (std::is_arithmetic<E>::value) {
+        return 64 / sizeof(E) < 4 ? 4 : 64 / sizeof(E);
+    } else {
+        return 1;
+    }
+}
+
+// partial result of one thread on its own cache line; done is set
+// when the value contains the whole subtree of the thread
+template <typename Acc>
+struct alignas(cacheline_size) Partial {
+    Acc value;
+    std::atomic<bool> done{false};
+};
+
+// Reduces n elements from p on. accumulate(acc, element) adds an
+// element, combine(acc, acc) merges two accumulators; they differ for
+// accumulators that are not of the element type (see kahan_sum).
+// The lanes are combined pairwise, so the order only depends on n.
+template <typename E, typename Acc, typename Accumulate, typename Combine>
+Acc reduce_chunk(const E* p, std::size_t n, const Acc& identity,
+    Accumulate& accumulate, Combine& combine) {
+    constexpr std::size_t lanes = lanes_for<E>();
+    Acc acc[lanes];
+    for (std::size_t j=0; j<lanes; ++j) {
+        acc[j] = identity;
+    }
+    std::size_t i = 0;
+    for (; i+lanes<=n; i+=lanes) {
+        for (std::size_t j=0; j<lanes; ++j) {
+            acc[j] = accumulate(acc[j], p[i+j]);
+        }
+    }
+    for (; i<n; ++i) {
+        acc[0] = accumulate(acc[0], p[i]);
+    }
+    for (std::size_t width=lanes/2; width>0; width/=2) {
+        for (std::size_t j=0; j<width; ++j) {
+            acc[j] = combine(acc[j], acc[j+width]);
+        }
+    }
+    return acc[0];
+}
+
+// thread i combines the subtrees of i + 1, i + 2, i + 4, ...
+// (as long as i is divisible by twice the distance) and then
+// reports its own subtree as done
+template <typename Acc, typename Combine>
+void tree_combine(Partial<Acc>* partials, std::size_t n, std::size_t i, Combine& combine) {
+    for (std::size_t stride=1; stride<n && i % (2*stride) == 0; stride*=2) {
+        if (i + stride < n) {
+            Partial<Acc>& other = partials[i + stride];
+            other.done.wait(false, std::memory_order_acquire);
+            partials[i].value = combine(partials[i].value, other.value);
+        }
+    }
+    partials[i].done.store(true, std::memory_order_release);
+    partials[i].done.notify_one();
+}
+
+// the general version behind all reductions
+template <typename E, typename Acc, typename Accumulate, typename Combine>
+Acc reduce(std::span<const E> s, Acc identity, Accumulate accumulate,
+    Combine combine, std::size_t threads) {
+    threads = std::clamp<std::size_t>(s.size() / min_chunk, 1, std::max<std::size_t>(threads, 1));
+    if (threads == 1) {
+        return reduce_chunk(s.data(), s.size(), identity, accumulate, combine);
+    }
+    std::unique_ptr<Partial<Acc>[]> partials(new Partial<Acc>[threads]);
+    auto work = [&](std::size_t t) {
+        const std::size_t first = s.size() * t / threads;
+        const std::size_t last = s.size() * (t + 1) / threads;
+        partials[t].value = reduce_chunk(s.data() + first, last - first,
+            identity, accumulate, combine);
+        tree_combine(partials.get(), threads, t, combine);
+    };
+    // the calling thread takes the first chunk and the root of the tree
+    std::vector<std::thread> workers;
+    for (std::size_t t=1; t<threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& w : workers) {
+        w.join();
+    }
+    return partials[0].value;
+}
+
+template <std::ranges::contiguous_range R>
+auto as_span(const R& r) {
+    using E = std::remove_cv_t<std::ranges::range_value_t<R>>;
+    return std::span<const E>(std::ranges::data(r), std::ranges::size(r));
+}
+
+// op must be associative and identity its neutral element,
+// e.g. std::plus<>() and 0
+template <std::ranges::contiguous_range R, typename T, typename Op>
+T parallel_reduce(const R& r, T identity, Op op, std::size_t threads = default_threads()) {
+    return reduce(as_span(r), identity, op, op, threads);
+}
+
+// Same result for any number of threads: fixed blocks, each reduced
+// by one thread, then a pairwise tree over all blocks in a fixed order.
+// The block results are written once per block, so false sharing
+// does not matter here.
+template <std::ranges::contiguous_range R, typename T, typename Op>
+T deterministic_reduce(const R& r, T identity, Op op, std::size_t threads = default_threads()) {
+    auto s = as_span(r);
+    const std::size_t blocks = (s.size() + deterministic_block - 1) / deterministic_block;
+    if (blocks == 0) {
+        return identity;
+    }
+    std::vector<T> results(blocks, identity);
+    auto work = [&](std::size_t first, std::size_t last) {
+        for (std::size_t b=first; b<last; ++b) {
+            const std::size_t begin = b * deterministic_block;
+            const std::size_t n = std::min(deterministic_block, s.size() - begin);
+            results[b] = reduce_chunk(s.data() + begin, n, identity, op, op);
+        }
+    };
+    threads = std::clamp<std::size_t>(s.size() / min_chunk, 1, std::max<std::size_t>(threads, 1));
+    std::vector<std::thread> workers;
+    for (std::size_t t=1; t<threads; ++t) {
+        workers.emplace_back(work, blocks * t / threads, blocks * (t + 1) / threads);
+    }
+    work(0, blocks / threads);
+    for (auto& w : workers) {
+        w.join();
+    }
+    for (std::size_t stride=1; stride<blocks; stride*=2) {
+        for (std::size_t b=0; b+stride<blocks; b+=2*stride) {
+            results[b] = op(results[b], results[b + stride]);
+        }
+    }
+    return results[0];
+}
+
+// sum and the rounding errors of all additions so far
+template <typename F>
+struct Compensated {
+    F sum = 0;
+    F error = 0;
+};
+
+// Knuth's TwoSum: s + err is exactly a + b; no branches, so the
+// lanes can still be vectorized
+template <typename F>
+Compensated<F> add_compensated(const Compensated<F>& acc, F x) {
+    const F s = acc.sum + x;
+    const F b = s - acc.sum;
+    const F err = (acc.sum - (s - b)) + (x - b);
+    return {s, acc.error + err};
+}
+
+template <std::ranges::contiguous_range R>
+auto kahan_sum(const R& r, std::size_t threads = default_threads()) {
+    using F = std::remove_cv_t<std::ranges::range_value_t<R>>;
+    static_assert(std::is_floating_point<F>::value, "kahan_sum is for floating point");
+    auto accumulate = [](const Compensated<F>& acc, F x) {
+        return add_compensated(acc, x);
+    };
+    auto combine = [](const Compensated<F>& a, const Compensated<F>& b) {
+        Compensated<F> c = add_compensated(a, b.sum);
+        c.error += b.error;
+        return c;
+    };
+    Compensated<F> result = reduce(as_span(r), Compensated<F>{}, accumulate, combine, threads);
+    return result.sum + result.error;
+}
+
+// ############ Benchmark ##############
+// what we had so far
+template <typename T, std::size_t A>
+T serial_sum(const Buffer<T, A>& b) {
+    T sum = 0;
+    for (std::size_t i=0; i<b.size(); ++i) {
+        sum += b[i];
+    }
+    return sum;
+}
+
+template <typename Func>
+double measure(Func f, std::size_t repetitions) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r=0; r<repetitions; ++r) {
+        f();
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    return dt.count() / repetitions;
+}
+
+
+int main() {
+    // any associative operator works, e.g. the maximum
+    Buffer<int> small(1000);
+    for (std::size_t i=0; i<small.size(); ++i) {
+        small[i] = static_cast<int>((i * 7919) % 1000);
+    }
+    std::cout << "maximum: " << parallel_reduce(small, std::numeric_limits<int>::min(),
+        [](int a, int b) { return std::max(a, b); }) << std::endl;
+
+    // values of very different magnitude, where rounding errors add up
+    constexpr std::size_t n = 1 << 23;
+    Buffer<double, cacheline_size> b(n, uninitialized);
+    for (std::size_t i=0; i<n; ++i) {
+        b[i] = (i % 2 == 0 ? 1.0 : 1e-8) / (1 + i % 1000);
+    }
+    // reference: compensated summation in long double; a plain long
+    // double sum is itself off by about 1e-15 here, which is more than
+    // the error of kahan_sum
+    Compensated<long double> reference;
+    for (std::size_t i=0; i<n; ++i) {
+        reference = add_compensated(reference, static_cast<long double>(b[i]));
+    }
+    const long double exact = reference.sum + reference.error;
+
+    const std::size_t max_threads = default_threads();
+    std::cout << std::setprecision(3) << std::scientific;
+    std::cout << "relative error of the sum (" << n << " doubles)" << std::endl;
+    auto error = [exact](double sum) {
+        return static_cast<double>(std::fabs((sum - exact) / exact));
+    };
+    std::cout << "    serial loop:          " << error(serial_sum(b)) << std::endl;
+    std::cout << "    parallel_reduce:      " << error(parallel_reduce(b, 0.0, std::plus<>())) << std::endl;
+    std::cout << "    deterministic_reduce: " << error(deterministic_reduce(b, 0.0, std::plus<>())) << std::endl;
+    std::cout << "    kahan_sum:            " << error(kahan_sum(b)) << std::endl;
+    std::cout << "deterministic_reduce with 1 and " << max_threads << " threads is identical: "
+        << std::boolalpha << (deterministic_reduce(b, 0.0, std::plus<>(), 1)
+            == deterministic_reduce(b, 0.0, std::plus<>(), max_threads)) << std::endl;
+
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads=1; threads<max_threads; threads*=2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    constexpr std::size_t repetitions = 10;
+    const double gigabytes = n * sizeof(double) / 1e9;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "GB/s (" << std::thread::hardware_concurrency() << " cores)" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(8) << "serial"
+        << std::setw(17) << "parallel_reduce" << std::setw(15) << "deterministic"
+        << std::setw(11) << "kahan_sum" << std::endl;
+    volatile double sink = 0;
+    const double serial = gigabytes / measure([&]() { sink = serial_sum(b); }, repetitions);
+    for (std::size_t threads : thread_counts) {
+        std::cout << std::setw(8) << threads << std::setw(8) << serial
+            << std::setw(17) << gigabytes / measure([&]() {
+                sink = parallel_reduce(b, 0.0, std::plus<>(), threads); }, repetitions)
+            << std::setw(15) << gigabytes / measure([&]() {
+                sink = deterministic_reduce(b, 0.0, std::plus<>(), threads); }, repetitions)
+            << std::setw(11) << gigabytes / measure([&]() {
+                sink = kahan_sum(b, threads); }, repetitions)
+            << std::endl;
+    }
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
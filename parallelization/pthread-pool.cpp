@@ -0,0 +1,849 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    A thread pool directly on the pthread interface. std::thread has
+    no portable way to configure a thread before it starts; with
+    pthreads every worker can be set up through its attributes:
+        - an affinity mask (pthread_attr_setaffinity_np): the worker
+          runs on these cpus from its first instruction on, and a
+          worker pinned to one cpu never migrates (no cold caches,
+          no waiting for a new time slice)
+        - the scheduling policy: SCHED_FIFO with a real-time priority
+          (needs CAP_SYS_NICE or root, otherwise pthread_create fails
+          with EPERM), or the normal policy with a nice value
+        - a name (at most 15 characters), shown by top -H, ps -L and
+          the debugger
+    Every worker has its own queue; post() picks the worker with the
+    fewest pending tasks (queued or running, ties are broken round
+    robin), post_to() a particular one (e.g. the one pinned next to
+    the data). The queues are protected by a RAII wrapper of
+    pthread_mutex_t, so the Lock of "../RAII/mutex-lock.cpp" works
+    with them, and the condition variable waits on such a Lock.
+    Errors of the pthread functions are thrown as std::system_error.
+
+    Every worker records its state (created, idle, running, exited),
+    the number of tasks, the time spent running and idle, the cpu it
+    ran on and how often it migrated. snapshot() can be called at any
+    time from any thread. The destructor runs the remaining tasks and
+    joins all workers.
+*/
+
+#include <mutex>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <latch>
+#include <algorithm>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// ############ Tracing policies ##############
+// A policy performs the locking and unlocking of the resource and
+// may record something around it:
+//     lock(r)    acquires r (blocking)
+//     unlock(r)  releases r
+//     locked(r)  r was acquired by try_lock, a timed lock or adopted
+// The Lock derives from its policy, so a policy may keep state per
+// Lock object, and an empty policy does not take any space.
+
+// the default policy does nothing else and is optimized away completely
+struct NoTracing {
+    template <typename T>
+    void lock(T& r) {
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+    }
+
+    template <typename T>
+    void locked(T&) {
+    }
+};
+
+
+// Lock without I/O; [[nodiscard]] at the constructors makes the
+// compiler warn about "Lock<std::mutex>{m};", which unlocks again
+// immediately (the attribute at the class covers functions that
+// return a Lock)
+template <typename T, typename Tracing = NoTracing>
+class [[nodiscard]] Lock : private Tracing {
+    private:
+        // a pointer instead of a reference, as a moved-from
+        // Lock does not refer to any resource
+        T* resource;
+        bool owns;
+
+    public:
+        // constructor locks the resource
+        [[nodiscard]] explicit Lock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        // only stores the resource, lock() is called later
+        Lock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        // does not block, check owns_lock() afterwards
+        [[nodiscard]] Lock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        // the resource is already locked by the calling thread
+        Lock(T& r, std::adopt_lock_t) : resource(&r), owns(true) {
+            Tracing::locked(*resource);
+        }
+
+        // waits at most for the given time (e.g. std::timed_mutex)
+        template <typename Rep, typename Period>
+        [[nodiscard]] Lock(T& r, const std::chrono::duration<Rep, Period>& timeout) :
+            resource(&r), owns(false) {
+            (void)try_lock_for(timeout);
+        }
+
+        // waits at most until the given point in time
+        template <typename Clock, typename Duration>
+        [[nodiscard]] Lock(T& r, const std::chrono::time_point<Clock, Duration>& deadline) :
+            resource(&r), owns(false) {
+            (void)try_lock_until(deadline);
+        }
+
+        // destructor releases the resource if it is owned
+        ~Lock() {
+            if (owns) {
+                unlock();
+            }
+        }
+
+        // the ownership can be passed on, but not copied
+        Lock(Lock&& other) noexcept :
+            Tracing(std::move(static_cast<Tracing&>(other))),
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        Lock& operator=(Lock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    unlock();
+                }
+                static_cast<Tracing&>(*this) = std::move(static_cast<Tracing&>(other));
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        // same errors as std::unique_lock
+        void lock() {
+            check();
+            Tracing::lock(*resource);
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock();
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+            check();
+            owns = resource->try_lock_for(timeout);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Clock, typename Duration>
+        [[nodiscard]] bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+            check();
+            owns = resource->try_lock_until(deadline);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            Tracing::unlock(*resource);
+        }
+
+        // gives up the ownership without unlocking
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// ############ RAII wrappers of pthread objects ##############
+constexpr std::size_t cacheline_size = 64;
+
+// pthread functions return the error code instead of setting errno
+inline void check(int error, const char* what) {
+    if (error != 0) {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+}
+
+// usable with Lock<PthreadMutex>
+class PthreadMutex {
+    private:
+        pthread_mutex_t m;
+
+    public:
+        PthreadMutex() {
+            check(pthread_mutex_init(&m, nullptr), "pthread_mutex_init");
+        }
+
+        ~PthreadMutex() {
+            pthread_mutex_destroy(&m);
+        }
+
+        PthreadMutex(const PthreadMutex&) = delete;
+        PthreadMutex& operator=(const PthreadMutex&) = delete;
+
+        void lock() {
+            check(pthread_mutex_lock(&m), "pthread_mutex_lock");
+        }
+
+        bool try_lock() {
+            const int error = pthread_mutex_trylock(&m);
+            if (error == EBUSY) {
+                return false;
+            }
+            check(error, "pthread_mutex_trylock");
+            return true;
+        }
+
+        void unlock() {
+            pthread_mutex_unlock(&m);
+        }
+
+        pthread_mutex_t* native_handle() {
+            return &m;
+        }
+};
+
+// waits on a Lock<PthreadMutex>, which has to own the mutex
+class PthreadCondition {
+    private:
+        pthread_cond_t c;
+
+    public:
+        PthreadCondition() {
+            check(pthread_cond_init(&c, nullptr), "pthread_cond_init");
+        }
+
+        ~PthreadCondition() {
+            pthread_cond_destroy(&c);
+        }
+
+        PthreadCondition(const PthreadCondition&) = delete;
+        PthreadCondition& operator=(const PthreadCondition&) = delete;
+
+        void wait(Lock<PthreadMutex>& lock) {
+            if (!lock.owns_lock()) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            check(pthread_cond_wait(&c, lock.mutex()->native_handle()), "pthread_cond_wait");
+        }
+
+        // waits until pred() is true (no lost or spurious wake-ups)
+        template <typename Predicate>
+        void wait(Lock<PthreadMutex>& lock, Predicate pred) {
+            while (!pred()) {
+                wait(lock);
+            }
+        }
+
+        void signal() {
+            pthread_cond_signal(&c);
+        }
+
+        void broadcast() {
+            pthread_cond_broadcast(&c);
+        }
+};
+
+class ThreadAttributes {
+    private:
+        pthread_attr_t attr;
+
+    public:
+        ThreadAttributes() {
+            check(pthread_attr_init(&attr), "pthread_attr_init");
+        }
+
+        ~ThreadAttributes() {
+            pthread_attr_destroy(&attr);
+        }
+
+        ThreadAttributes(const ThreadAttributes&) = delete;
+        ThreadAttributes& operator=(const ThreadAttributes&) = delete;
+
+        void set_affinity(const std::vector<int>& cpus) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpus) {
+                CPU_SET(cpu, &set);
+            }
+            check(pthread_attr_setaffinity_np(&attr, sizeof(set), &set),
+                "pthread_attr_setaffinity_np");
+        }
+
+        // without PTHREAD_EXPLICIT_SCHED the new thread would
+        // inherit the policy of the creating thread
+        void set_fifo(int priority) {
+            check(pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED),
+                "pthread_attr_setinheritsched");
+            check(pthread_attr_setschedpolicy(&attr, SCHED_FIFO),
+                "pthread_attr_setschedpolicy");
+            sched_param param{};
+            param.sched_priority = priority;
+            check(pthread_attr_setschedparam(&attr, &param), "pthread_attr_setschedparam");
+        }
+
+        pthread_attr_t* native_handle() {
+            return &attr;
+        }
+};
+
+// ############ Pool ##############
+class Job {
+    public:
+        virtual ~Job() = default;
+        virtual void run() = 0;
+};
+
+template <typename F>
+class FunctionJob : public Job {
+    private:
+        F f;
+
+    public:
+        template <typename G>
+        explicit FunctionJob(G&& function) : f(std::forward<G>(function)) {
+        }
+
+        void run() override {
+            f();
+        }
+};
+
+struct WorkerConfig {
+    enum class Policy { normal, fifo };
+
+    // at most 15 characters, longer names are cut
+    std::string name;
+    // empty: the worker may run on every cpu
+    std::vector<int> cpus;
+    Policy policy = Policy::normal;
+    // SCHED_FIFO priority, 1 (low) to 99 (high)
+    int priority = 1;
+    // nice value for the normal policy, -20 (high) to 19 (low);
+    // negative values need CAP_SYS_NICE
+    int nice = 0;
+};
+
+enum class WorkerState : int { created, idle, running, exited };
+
+inline const char* to_string(WorkerState s) {
+    switch (s) {
+        case WorkerState::created: return "created";
+        case WorkerState::idle: return "idle";
+        case WorkerState::running: return "running";
+        case WorkerState::exited: return "exited";
+    }
+    return "?";
+}
+
+// what snapshot() reports per worker
+struct WorkerInfo {
+    std::string name;
+    pid_t tid;
+    WorkerState state;
+    std::string affinity;
+    std::string scheduling;
+    int cpu;
+    std::uint64_t migrations;
+    std::uint64_t tasks;
+    std::uint64_t failures;
+    // queued plus the one currently running
+    std::size_t pending;
+    double busy_ms;
+    double idle_ms;
+};
+
+class PthreadPool {
+    private:
+        // counters are only written by the worker itself
+        struct alignas(cacheline_size) Worker {
+            WorkerConfig config;
+            pthread_t thread{};
+
+            PthreadMutex mutex;
+            PthreadCondition wakeup;
+            std::deque<std::unique_ptr<Job>> jobs;
+            bool stopping = false;
+            // incremented on push, decremented after the task ran
+            std::atomic<std::size_t> pending{0};
+
+            std::atomic<WorkerState> state{WorkerState::created};
+            std::atomic<int> setup_error{0};
+            std::atomic<pid_t> tid{0};
+            std::atomic<int> cpu{-1};
+            std::atomic<std::uint64_t> migrations{0};
+            std::atomic<std::uint64_t> tasks{0};
+            std::atomic<std::uint64_t> failures{0};
+            std::atomic<std::uint64_t> busy_ns{0};
+            std::atomic<std::uint64_t> idle_ns{0};
+            // start of the current state
+            std::atomic<std::uint64_t> since_ns{0};
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        // first worker post() looks at
+        std::atomic<std::size_t> next{0};
+
+        static std::uint64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // single writer, so no read-modify-write is needed
+        static void add(std::atomic<std::uint64_t>& counter, std::uint64_t x) {
+            counter.store(counter.load(std::memory_order_relaxed) + x,
+                std::memory_order_relaxed);
+        }
+
+        // the parts of the configuration that can only be
+        // applied by the thread itself
+        static void setup(Worker& w) {
+            w.tid.store(gettid(), std::memory_order_relaxed);
+            pthread_setname_np(pthread_self(), w.config.name.substr(0, 15).c_str());
+            if (w.config.policy == WorkerConfig::Policy::normal && w.config.nice != 0) {
+                if (setpriority(PRIO_PROCESS, gettid(), w.config.nice) != 0) {
+                    w.setup_error.store(errno, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // switches the state and books the time of the previous one
+        static void enter(Worker& w, WorkerState next, std::atomic<std::uint64_t>& previous) {
+            const std::uint64_t t = now_ns();
+            add(previous, t - w.since_ns.load(std::memory_order_relaxed));
+            w.since_ns.store(t, std::memory_order_relaxed);
+            w.state.store(next, std::memory_order_release);
+        }
+
+        static void* entry(void* arg) {
+            Worker& w = *static_cast<Worker*>(arg);
+            setup(w);
+            w.since_ns.store(now_ns(), std::memory_order_relaxed);
+            w.state.store(WorkerState::idle, std::memory_order_release);
+            w.state.notify_all();
+            for (;;) {
+                std::unique_ptr<Job> job;
+                {
+                    Lock<PthreadMutex> lock(w.mutex);
+                    w.wakeup.wait(lock, [&w]() { return w.stopping || !w.jobs.empty(); });
+                    if (w.jobs.empty()) {
+                        break;
+                    }
+                    job = std::move(w.jobs.front());
+                    w.jobs.pop_front();
+                }
+                enter(w, WorkerState::running, w.idle_ns);
+                const int cpu = sched_getcpu();
+                const int last = w.cpu.exchange(cpu, std::memory_order_relaxed);
+                if (last != -1 && last != cpu) {
+                    add(w.migrations, 1);
+                }
+                // a failing task must not take the worker down
+                try {
+                    job->run();
+                } catch (...) {
+                    add(w.failures, 1);
+                }
+                add(w.tasks, 1);
+                w.pending.fetch_sub(1, std::memory_order_relaxed);
+                enter(w, WorkerState::idle, w.busy_ns);
+            }
+            enter(w, WorkerState::exited, w.idle_ns);
+            return nullptr;
+        }
+
+        void start(Worker& w) {
+            ThreadAttributes attr;
+            if (!w.config.cpus.empty()) {
+                attr.set_affinity(w.config.cpus);
+            }
+            if (w.config.policy == WorkerConfig::Policy::fifo) {
+                attr.set_fifo(w.config.priority);
+            }
+            check(pthread_create(&w.thread, attr.native_handle(), &PthreadPool::entry, &w),
+                "pthread_create");
+        }
+
+        // stops and joins the workers that were started
+        void shutdown() {
+            for (auto& w : workers) {
+                if (w->thread != pthread_t{}) {
+                    {
+                        Lock<PthreadMutex> lock(w->mutex);
+                        w->stopping = true;
+                    }
+                    w->wakeup.signal();
+                }
+            }
+            for (auto& w : workers) {
+                if (w->thread != pthread_t{}) {
+                    pthread_join(w->thread, nullptr);
+                    w->thread = pthread_t{};
+                }
+            }
+        }
+
+        static std::string affinity_of(pthread_t thread) {
+            cpu_set_t set;
+            if (pthread_getaffinity_np(thread, sizeof(set), &set) != 0) {
+                return "?";
+            }
+            std::ostringstream out;
+            int count = 0;
+            for (int cpu=0; cpu<CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    out << (count++ > 0 ? "," : "") << cpu;
+                }
+            }
+            return out.str();
+        }
+
+        static std::string scheduling_of(pthread_t thread, pid_t tid) {
+            int policy;
+            sched_param param{};
+            if (pthread_getschedparam(thread, &policy, &param) != 0) {
+                return "?";
+            }
+            if (policy == SCHED_FIFO) {
+                return "fifo " + std::to_string(param.sched_priority);
+            }
+            errno = 0;
+            const int nice = getpriority(PRIO_PROCESS, tid);
+            return "nice " + std::to_string(errno == 0 ? nice : 0);
+        }
+
+    public:
+        // either all workers run with their configuration, or the
+        // constructor throws (and stops the ones already started)
+        explicit PthreadPool(std::vector<WorkerConfig> configs) {
+            if (configs.empty()) {
+                throw std::invalid_argument("PthreadPool needs at least one worker");
+            }
+            for (auto& config : configs) {
+                auto w = std::make_unique<Worker>();
+                w->config = std::move(config);
+                workers.push_back(std::move(w));
+            }
+            try {
+                for (auto& w : workers) {
+                    start(*w);
+                }
+                for (auto& w : workers) {
+                    w->state.wait(WorkerState::created, std::memory_order_acquire);
+                    check(w->setup_error.load(std::memory_order_relaxed), "setpriority");
+                }
+            } catch (...) {
+                shutdown();
+                throw;
+            }
+        }
+
+        // the cpus this process may run on; in a cpuset (e.g. a
+        // container) these are not simply 0 to the number of cpus,
+        // and pinning to any other cpu fails with EINVAL
+        static std::vector<int> allowed_cpus() {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+                check(errno, "sched_getaffinity");
+            }
+            std::vector<int> cpus;
+            for (int cpu=0; cpu<CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+            return cpus;
+        }
+
+        // n workers named prefix-i, worker i pinned to the i-th
+        // allowed cpu (modulo the number of allowed cpus)
+        static std::vector<WorkerConfig> pinned(std::size_t n, const std::string& prefix) {
+            const std::vector<int> cpus = allowed_cpus();
+            std::vector<WorkerConfig> configs(n);
+            for (std::size_t i=0; i<n; ++i) {
+                configs[i].name = prefix + "-" + std::to_string(i);
+                configs[i].cpus = {cpus[i % cpus.size()]};
+            }
+            return configs;
+        }
+
+        ~PthreadPool() {
+            shutdown();
+        }
+
+        PthreadPool(const PthreadPool&) = delete;
+        PthreadPool& operator=(const PthreadPool&) = delete;
+
+        std::size_t size() const {
+            return workers.size();
+        }
+
+        template <typename F>
+        void post_to(std::size_t index, F&& f) {
+            Worker& w = *workers.at(index);
+            auto job = std::make_unique<FunctionJob<std::decay_t<F>>>(std::forward<F>(f));
+            {
+                Lock<PthreadMutex> lock(w.mutex);
+                w.jobs.push_back(std::move(job));
+                w.pending.fetch_add(1, std::memory_order_relaxed);
+            }
+            w.wakeup.signal();
+        }
+
+        // to the worker with the fewest pending tasks; the search
+        // starts at a different worker every time, so ties (e.g. all
+        // workers idle) do not always go to the same one
+        template <typename F>
+        void post(F&& f) {
+            const std::size_t n = workers.size();
+            const std::size_t first = next.fetch_add(1, std::memory_order_relaxed) % n;
+            std::size_t best = first;
+            std::size_t load = workers[best]->pending.load(std::memory_order_relaxed);
+            for (std::size_t k=1; k<n && load > 0; ++k) {
+                const std::size_t i = (first + k) % n;
+                const std::size_t l = workers[i]->pending.load(std::memory_order_relaxed);
+                if (l < load) {
+                    best = i;
+                    load = l;
+                }
+            }
+            post_to(best, std::forward<F>(f));
+        }
+
+        // consistent per counter, not across counters
+        std::vector<WorkerInfo> snapshot() const {
+            std::vector<WorkerInfo> infos;
+            const std::uint64_t t = now_ns();
+            for (const auto& w : workers) {
+                WorkerInfo info;
+                info.name = w->config.name;
+                info.tid = w->tid.load(std::memory_order_relaxed);
+                info.state = w->state.load(std::memory_order_acquire);
+                const bool alive = info.state != WorkerState::exited
+                    && w->thread != pthread_t{};
+                info.affinity = alive ? affinity_of(w->thread) : "-";
+                info.scheduling = alive ? scheduling_of(w->thread, info.tid) : "-";
+                info.cpu = w->cpu.load(std::memory_order_relaxed);
+                info.migrations = w->migrations.load(std::memory_order_relaxed);
+                info.tasks = w->tasks.load(std::memory_order_relaxed);
+                info.failures = w->failures.load(std::memory_order_relaxed);
+                info.pending = w->pending.load(std::memory_order_relaxed);
+                // plus the time spent in the current state so far
+                const std::uint64_t current = t - std::min(t, w->since_ns.load(std::memory_order_relaxed));
+                std::uint64_t busy = w->busy_ns.load(std::memory_order_relaxed);
+                std::uint64_t idle = w->idle_ns.load(std::memory_order_relaxed);
+                if (info.state == WorkerState::running) {
+                    busy += current;
+                } else if (info.state == WorkerState::idle) {
+                    idle += current;
+                }
+                info.busy_ms = busy / 1e6;
+                info.idle_ms = idle / 1e6;
+                infos.push_back(std::move(info));
+            }
+            return infos;
+        }
+
+        void print(std::ostream& out) const {
+            out << std::setw(12) << "name" << std::setw(8) << "tid" << std::setw(9) << "state"
+                << std::setw(10) << "affinity" << std::setw(9) << "sched" << std::setw(5) << "cpu"
+                << std::setw(7) << "migr." << std::setw(8) << "tasks" << std::setw(7) << "failed"
+                << std::setw(8) << "pending" << std::setw(10) << "busy ms"
+                << std::setw(10) << "idle ms" << std::endl;
+            out << std::fixed << std::setprecision(1);
+            for (const WorkerInfo& i : snapshot()) {
+                out << std::setw(12) << i.name << std::setw(8) << i.tid
+                    << std::setw(9) << to_string(i.state) << std::setw(10) << i.affinity
+                    << std::setw(9) << i.scheduling << std::setw(5) << i.cpu
+                    << std::setw(7) << i.migrations << std::setw(8) << i.tasks
+                    << std::setw(7) << i.failures << std::setw(8) << i.pending
+                    << std::setw(10) << i.busy_ms << std::setw(10) << i.idle_ms << std::endl;
+            }
+        }
+};
+
+// ############ Demonstration ##############
+inline std::uint64_t spin_work(std::uint64_t x, int rounds) {
+    for (int i=0; i<rounds; ++i) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return x;
+}
+
+
+int main() {
+    const std::size_t n = std::max<std::size_t>(2, PthreadPool::allowed_cpus().size());
+
+    // latency-critical workers: pinned and real-time; without the
+    // permission for SCHED_FIFO we fall back to pinned normal workers
+    std::vector<WorkerConfig> configs = PthreadPool::pinned(n, "rt-worker");
+    for (auto& c : configs) {
+        c.policy = WorkerConfig::Policy::fifo;
+        c.priority = 10;
+    }
+    // everything the tasks refer to is declared before the pool, so
+    // it is destroyed only after the pool has joined its workers (a
+    // worker may still be inside count_down or notify_one when the
+    // waiting thread already continues)
+    constexpr std::size_t tasks = 2000;
+    std::latch done(tasks);
+    std::atomic<std::uint64_t> sink{0};
+    std::atomic<bool> finished{false};
+
+    std::unique_ptr<PthreadPool> pool;
+    try {
+        pool = std::make_unique<PthreadPool>(configs);
+    } catch (const std::system_error& e) {
+        std::cout << "SCHED_FIFO not available (" << e.what()
+            << "), using nice workers" << std::endl;
+        configs = PthreadPool::pinned(n, "worker");
+        configs.back().nice = 5;
+        pool = std::make_unique<PthreadPool>(configs);
+    }
+
+    // a mix of short and long tasks, some of them to worker 0 only
+    for (std::size_t i=0; i<tasks; ++i) {
+        auto task = [&done, &sink, i]() {
+            sink.fetch_add(spin_work(i, i % 10 == 0 ? 200000 : 2000) & 1,
+                std::memory_order_relaxed);
+            done.count_down();
+        };
+        if (i % 4 == 0) {
+            pool->post_to(0, task);
+        } else {
+            pool->post(task);
+        }
+    }
+    pool->post([]() { throw std::runtime_error("this task fails"); });
+    std::cout << "while running:" << std::endl;
+    pool->print(std::cout);
+    done.wait();
+
+    // round trip to a pinned worker
+    std::vector<double> latencies;
+    for (int i=0; i<2000; ++i) {
+        finished.store(false, std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        pool->post_to(0, [&finished]() {
+            finished.store(true, std::memory_order_release);
+            finished.notify_one();
+        });
+        finished.wait(false, std::memory_order_acquire);
+        std::chrono::duration<double, std::micro> dt = std::chrono::steady_clock::now() - start;
+        latencies.push_back(dt.count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::fixed << std::setprecision(2)
+        << "round trip to worker 0 in us (median / 99%): "
+        << latencies[latencies.size() / 2] << " / "
+        << latencies[latencies.size() * 99 / 100] << std::endl;
+
+    std::cout << "after all tasks:" << std::endl;
+    pool->print(std::cout);
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
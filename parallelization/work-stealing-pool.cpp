@@ -0,0 +1,770 @@
+/* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    A thread pool keeps a fixed number of threads alive and hands them
+    tasks, so a parallel algorithm does not have to start its own
+    threads. The simplest pool has one queue behind a mutex and a
+    condition variable; with many short tasks all threads fight for
+    this one mutex. This pool uses work stealing instead:
+        - every worker has its own Chase-Lev deque. The owner pushes
+          and pops at the bottom without any lock (LIFO, the data of
+          the latest task is still in the cache), other workers steal
+          the oldest tasks from the top.
+        - tasks submitted from outside the pool go to an injection
+          queue, which the workers check when their deque is empty
+        - idle workers try to steal for a short while and then sleep
+          on an atomic counter (futex), which submit() increments
+        - optionally every worker is pinned to one cpu
+    submit() returns a std::future with the result (or the exception)
+    of the task, post() is fire-and-forget. The destructor is the
+    shutdown: it lets the workers finish all tasks submitted so far
+    (RAII as for the Lock in "../RAII/mutex-lock.cpp") and joins them.
+
+    The main function compares the task throughput and the latency
+    of a single task with a mutex/condition variable pool.
+*/
+
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <latch>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+#include <pthread.h>
+#include <sched.h>
+
+#if __cplusplus < 201709L
+#error This file requires compiler and library support for the \
+ISO C++ 2020 standard.
+#else
+
+// ############ Tracing policies ##############
+// A policy performs the locking and unlocking of the resource and
+// may record something around it:
+//     lock(r)    acquires r (blocking)
+//     unlock(r)  releases r
+//     locked(r)  r was acquired by try_lock, a timed lock or adopted
+// The Lock derives from its policy, so a policy may keep state per
+// Lock object, and an empty policy does not take any space.
+
+// the default policy does nothing else and is optimized away completely
+struct NoTracing {
+    template <typename T>
+    void lock(T& r) {
+        r.lock();
+    }
+
+    template <typename T>
+    void unlock(T& r) {
+        r.unlock();
+    }
+
+    template <typename T>
+    void locked(T&) {
+    }
+};
+
+
+// Lock without I/O; [[nodiscard]] at the constructors makes the
+// compiler warn about "Lock<std::mutex>{m};", which unlocks again
+// immediately (the attribute at the class covers functions that
+// return a Lock)
+template <typename T, typename Tracing = NoTracing>
+class [[nodiscard]] Lock : private Tracing {
+    private:
+        // a pointer instead of a reference, as a moved-from
+        // Lock does not refer to any resource
+        T* resource;
+        bool owns;
+
+    public:
+        // constructor locks the resource
+        [[nodiscard]] explicit Lock(T& r) : resource(&r), owns(false) {
+            lock();
+        }
+
+        // only stores the resource, lock() is called later
+        Lock(T& r, std::defer_lock_t) noexcept : resource(&r), owns(false) {
+        }
+
+        // does not block, check owns_lock() afterwards
+        [[nodiscard]] Lock(T& r, std::try_to_lock_t) : resource(&r), owns(false) {
+            (void)try_lock();
+        }
+
+        // the resource is already locked by the calling thread
+        Lock(T& r, std::adopt_lock_t) : resource(&r), owns(true) {
+            Tracing::locked(*resource);
+        }
+
+        // waits at most for the given time (e.g. std::timed_mutex)
+        template <typename Rep, typename Period>
+        [[nodiscard]] Lock(T& r, const std::chrono::duration<Rep, Period>& timeout) :
+            resource(&r), owns(false) {
+            (void)try_lock_for(timeout);
+        }
+
+        // waits at most until the given point in time
+        template <typename Clock, typename Duration>
+        [[nodiscard]] Lock(T& r, const std::chrono::time_point<Clock, Duration>& deadline) :
+            resource(&r), owns(false) {
+            (void)try_lock_until(deadline);
+        }
+
+        // destructor releases the resource if it is owned
+        ~Lock() {
+            if (owns) {
+                unlock();
+            }
+        }
+
+        // the ownership can be passed on, but not copied
+        Lock(Lock&& other) noexcept :
+            Tracing(std::move(static_cast<Tracing&>(other))),
+            resource(std::exchange(other.resource, nullptr)),
+            owns(std::exchange(other.owns, false)) {
+        }
+
+        Lock& operator=(Lock&& other) noexcept {
+            if (this != &other) {
+                if (owns) {
+                    unlock();
+                }
+                static_cast<Tracing&>(*this) = std::move(static_cast<Tracing&>(other));
+                resource = std::exchange(other.resource, nullptr);
+                owns = std::exchange(other.owns, false);
+            }
+            return *this;
+        }
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        // same errors as std::unique_lock
+        void lock() {
+            check();
+            Tracing::lock(*resource);
+            owns = true;
+        }
+
+        [[nodiscard]] bool try_lock() {
+            check();
+            owns = resource->try_lock();
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+            check();
+            owns = resource->try_lock_for(timeout);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        template <typename Clock, typename Duration>
+        [[nodiscard]] bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+            check();
+            owns = resource->try_lock_until(deadline);
+            if (owns) {
+                Tracing::locked(*resource);
+            }
+            return owns;
+        }
+
+        void unlock() {
+            if (!owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            owns = false;
+            Tracing::unlock(*resource);
+        }
+
+        // gives up the ownership without unlocking
+        T* release() noexcept {
+            owns = false;
+            return std::exchange(resource, nullptr);
+        }
+
+        bool owns_lock() const noexcept {
+            return owns;
+        }
+
+        explicit operator bool() const noexcept {
+            return owns;
+        }
+
+        T* mutex() const noexcept {
+            return resource;
+        }
+
+    private:
+        void check() const {
+            if (resource == nullptr) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::operation_not_permitted));
+            }
+            if (owns) {
+                throw std::system_error(
+                    std::make_error_code(std::errc::resource_deadlock_would_occur));
+            }
+        }
+};
+
+// ############ Tasks and deque ##############
+constexpr std::size_t cacheline_size = 64;
+
+// type-erased task; the queues only move pointers around
+class Task {
+    public:
+        virtual ~Task() = default;
+        virtual void run() = 0;
+};
+
+template <typename F>
+class FunctionTask : public Task {
+    private:
+        F f;
+
+    public:
+        template <typename G>
+        explicit FunctionTask(G&& function) : f(std::forward<G>(function)) {
+        }
+
+        void run() override {
+            f();
+        }
+};
+
+template <typename F>
+std::unique_ptr<Task> make_task(F&& f) {
+    return std::make_unique<FunctionTask<std::decay_t<F>>>(std::forward<F>(f));
+}
+
+// Chase-Lev work-stealing deque, with the memory orders of
+// Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (2013).
+// Only the owner calls push() and pop(), everybody may call steal().
+class WorkStealingDeque {
+    private:
+        // ring buffer with a power-of-two capacity
+        struct Array {
+            std::int64_t mask;
+            std::unique_ptr<std::atomic<Task*>[]> slots;
+
+            explicit Array(std::int64_t capacity) :
+                mask(capacity - 1), slots(new std::atomic<Task*>[capacity]) {
+            }
+
+            Task* get(std::int64_t i) const {
+                return slots[i & mask].load(std::memory_order_relaxed);
+            }
+
+            void put(std::int64_t i, Task* t) {
+                slots[i & mask].store(t, std::memory_order_relaxed);
+            }
+        };
+
+        alignas(cacheline_size) std::atomic<std::int64_t> top{0};
+        alignas(cacheline_size) std::atomic<std::int64_t> bottom{0};
+        std::atomic<Array*> array;
+        // a thief may still read from an old array, so the arrays
+        // are only freed with the deque (they double, so this costs
+        // at most as much memory as the current array)
+        std::vector<std::unique_ptr<Array>> arrays;
+
+    public:
+        explicit WorkStealingDeque(std::int64_t capacity = 256) {
+            arrays.push_back(std::make_unique<Array>(capacity));
+            array.store(arrays.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        // remaining tasks are deleted
+        ~WorkStealingDeque() {
+            while (Task* t = pop()) {
+                delete t;
+            }
+        }
+
+        void push(Task* t) {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed);
+            const std::int64_t tp = top.load(std::memory_order_acquire);
+            Array* a = array.load(std::memory_order_relaxed);
+            if (b - tp > a->mask) {
+                auto bigger = std::make_unique<Array>(2*(a->mask + 1));
+                for (std::int64_t i=tp; i<b; ++i) {
+                    bigger->put(i, a->get(i));
+                }
+                a = bigger.get();
+                arrays.push_back(std::move(bigger));
+                array.store(a, std::memory_order_release);
+            }
+            a->put(b, t);
+            // publishes the task to the thieves (a release fence
+            // and a relaxed store in the paper)
+            bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // newest task of the owner or nullptr
+        Task* pop() {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            Array* a = array.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t tp = top.load(std::memory_order_relaxed);
+            if (tp > b) {
+                // empty
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            Task* t = a->get(b);
+            if (tp == b) {
+                // the last task, a thief might take it at the same time
+                if (!top.compare_exchange_strong(tp, tp + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    t = nullptr;
+                }
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return t;
+        }
+
+        // oldest task or nullptr (also if another thread was faster)
+        Task* steal() {
+            std::int64_t tp = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t b = bottom.load(std::memory_order_acquire);
+            if (tp >= b) {
+                return nullptr;
+            }
+            Task* t = array.load(std::memory_order_acquire)->get(tp);
+            if (!top.compare_exchange_strong(tp, tp + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return t;
+        }
+
+        bool empty() const {
+            return bottom.load(std::memory_order_relaxed)
+                <= top.load(std::memory_order_relaxed);
+        }
+};
+
+// ############ Work-stealing pool ##############
+enum class Pinning { none, cores };
+
+class ThreadPool {
+    private:
+        struct alignas(cacheline_size) Worker {
+            WorkStealingDeque deque;
+            std::thread thread;
+        };
+
+        // number of steal rounds before an idle worker goes to sleep
+        static constexpr unsigned spin_rounds = 64;
+
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        std::mutex injection_mutex;
+        std::deque<Task*> injection;
+        std::atomic<std::size_t> injected{0};
+
+        // incremented for every task that might wake a sleeper
+        alignas(cacheline_size) std::atomic<std::uint32_t> epoch{0};
+        std::atomic<std::uint32_t> sleeping{0};
+        std::atomic<bool> stopping{false};
+
+        // the pool and index of the worker running on this thread
+        struct Current {
+            ThreadPool* pool = nullptr;
+            std::size_t index = 0;
+        };
+
+        static Current& current() {
+            thread_local Current c;
+            return c;
+        }
+
+        Task* pop_injected() {
+            if (injected.load(std::memory_order_relaxed) == 0) {
+                return nullptr;
+            }
+            Lock<std::mutex> lock(injection_mutex);
+            if (injection.empty()) {
+                return nullptr;
+            }
+            Task* t = injection.front();
+            injection.pop_front();
+            injected.fetch_sub(1, std::memory_order_relaxed);
+            return t;
+        }
+
+        // own deque first, then the injection queue, then the
+        // other workers, starting at a random one
+        Task* find_task(std::size_t index, std::uint64_t& random) {
+            if (Task* t = workers[index]->deque.pop()) {
+                return t;
+            }
+            if (Task* t = pop_injected()) {
+                return t;
+            }
+            const std::size_t n = workers.size();
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            const std::size_t start = random % n;
+            for (std::size_t k=0; k<n; ++k) {
+                const std::size_t victim = (start + k) % n;
+                if (victim != index) {
+                    if (Task* t = workers[victim]->deque.steal()) {
+                        return t;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        static void execute(Task* t) {
+            std::unique_ptr<Task> task(t);
+            task->run();
+        }
+
+        void work(std::size_t index) {
+            current() = Current{this, index};
+            std::uint64_t random = 0x9e3779b97f4a7c15ULL * (index + 1);
+            for (;;) {
+                Task* t = nullptr;
+                for (unsigned round=0; round<spin_rounds && t == nullptr; ++round) {
+                    t = find_task(index, random);
+                    if (t == nullptr && round > spin_rounds / 2) {
+                        std::this_thread::yield();
+                    }
+                }
+                if (t != nullptr) {
+                    execute(t);
+                    continue;
+                }
+                // announce the sleep before the last check, so that a
+                // submit() in between either is seen by the check or
+                // sees the sleeper and changes the epoch
+                sleeping.fetch_add(1, std::memory_order_seq_cst);
+                const std::uint32_t e = epoch.load(std::memory_order_seq_cst);
+                t = find_task(index, random);
+                if (t == nullptr && !stopping.load(std::memory_order_acquire)) {
+                    epoch.wait(e, std::memory_order_acquire);
+                }
+                sleeping.fetch_sub(1, std::memory_order_relaxed);
+                if (t != nullptr) {
+                    execute(t);
+                } else if (stopping.load(std::memory_order_acquire)) {
+                    // the own deque is empty, and as no worker pushes
+                    // anything into other deques, nothing is lost
+                    t = find_task(index, random);
+                    if (t == nullptr) {
+                        return;
+                    }
+                    execute(t);
+                }
+            }
+        }
+
+        void wake_one() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeping.load(std::memory_order_relaxed) > 0) {
+                epoch.fetch_add(1, std::memory_order_release);
+                epoch.notify_one();
+            }
+        }
+
+        void schedule(std::unique_ptr<Task> task) {
+            Current& c = current();
+            if (c.pool == this) {
+                // from a worker: into its own deque, no lock at all
+                workers[c.index]->deque.push(task.release());
+            } else {
+                Lock<std::mutex> lock(injection_mutex);
+                injection.push_back(task.release());
+                injected.fetch_add(1, std::memory_order_relaxed);
+            }
+            wake_one();
+        }
+
+        static void pin(std::thread& thread, std::size_t cpu) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+        }
+
+    public:
+        explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency(),
+            Pinning pinning = Pinning::none) {
+            if (threads == 0) {
+                threads = 1;
+            }
+            // all deques exist before the first worker starts stealing
+            for (std::size_t i=0; i<threads; ++i) {
+                workers.push_back(std::make_unique<Worker>());
+            }
+            const std::size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+            for (std::size_t i=0; i<threads; ++i) {
+                workers[i]->thread = std::thread(&ThreadPool::work, this, i);
+                if (pinning == Pinning::cores) {
+                    pin(workers[i]->thread, i % cpus);
+                }
+            }
+        }
+
+        // finishes all submitted tasks, then joins the workers
+        ~ThreadPool() {
+            stopping.store(true, std::memory_order_release);
+            epoch.fetch_add(1, std::memory_order_release);
+            epoch.notify_all();
+            for (auto& w : workers) {
+                w->thread.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const {
+            return workers.size();
+        }
+
+        // fire-and-forget; an exception in f terminates the
+        // program (as in a std::thread)
+        template <typename F>
+        void post(F&& f) {
+            schedule(make_task(std::forward<F>(f)));
+        }
+
+        template <typename F, typename... Args>
+        auto submit(F&& f, Args&&... args) {
+            using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+            std::packaged_task<R()> task(
+                [f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable {
+                    return std::invoke(std::move(f), std::move(args)...);
+                });
+            std::future<R> result = task.get_future();
+            schedule(make_task(std::move(task)));
+            return result;
+        }
+};
+
+// ############ Benchmark ##############
+// the classic pool: one queue, one mutex, one condition variable
+class QueuePool {
+    private:
+        std::vector<std::thread> threads;
+        std::mutex m;
+        std::condition_variable cv;
+        std::deque<std::unique_ptr<Task>> queue;
+        bool stopping = false;
+
+        void work() {
+            for (;;) {
+                std::unique_ptr<Task> task;
+                {
+                    std::unique_lock<std::mutex> lock(m);
+                    cv.wait(lock, [this]() { return stopping || !queue.empty(); });
+                    if (queue.empty()) {
+                        return;
+                    }
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                }
+                task->run();
+            }
+        }
+
+        void schedule(std::unique_ptr<Task> task) {
+            {
+                Lock<std::mutex> lock(m);
+                queue.push_back(std::move(task));
+            }
+            cv.notify_one();
+        }
+
+    public:
+        explicit QueuePool(std::size_t n = std::thread::hardware_concurrency()) {
+            for (std::size_t i=0; i<std::max<std::size_t>(n, 1); ++i) {
+                threads.emplace_back(&QueuePool::work, this);
+            }
+        }
+
+        ~QueuePool() {
+            {
+                Lock<std::mutex> lock(m);
+                stopping = true;
+            }
+            cv.notify_all();
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+
+        template <typename F>
+        void post(F&& f) {
+            schedule(make_task(std::forward<F>(f)));
+        }
+
+        template <typename F>
+        auto submit(F&& f) {
+            using R = std::invoke_result_t<std::decay_t<F>>;
+            std::packaged_task<R()> task(std::forward<F>(f));
+            std::future<R> result = task.get_future();
+            schedule(make_task(std::move(task)));
+            return result;
+        }
+};
+
+// a little bit of work per task
+inline std::uint64_t spin_work(std::uint64_t x) {
+    for (int i=0; i<64; ++i) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return x;
+}
+
+constexpr std::size_t root_tasks = 256;
+constexpr std::size_t child_tasks = 1024;
+
+// fine-grained tasks that create more tasks, as in a recursive
+// divide and conquer; returns million tasks per second
+template <typename Pool>
+double throughput(std::size_t threads) {
+    // declared before the pool, so they outlive the workers, which
+    // may still be inside count_down when done.wait() returns
+    std::latch done(root_tasks * child_tasks);
+    std::atomic<std::uint64_t> sink{0};
+    Pool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r=0; r<root_tasks; ++r) {
+        pool.post([&pool, &done, &sink, r]() {
+            for (std::size_t c=0; c<child_tasks; ++c) {
+                pool.post([&done, &sink, r, c]() {
+                    sink.fetch_add(spin_work(r * child_tasks + c) & 1,
+                        std::memory_order_relaxed);
+                    done.count_down();
+                });
+            }
+        });
+    }
+    done.wait();
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    return root_tasks * child_tasks / dt.count() / 1e6;
+}
+
+// time from submit() until the result is there, in microseconds;
+// returns the median and the 99th percentile
+template <typename Pool>
+std::pair<double, double> latency(std::size_t threads) {
+    Pool pool(threads);
+    constexpr std::size_t samples = 10000;
+    std::vector<double> times;
+    times.reserve(samples);
+    for (std::size_t i=0; i<samples; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        pool.submit([i]() { return spin_work(i); }).get();
+        std::chrono::duration<double, std::micro> dt =
+            std::chrono::steady_clock::now() - start;
+        times.push_back(dt.count());
+    }
+    std::sort(times.begin(), times.end());
+    return {times[samples / 2], times[samples * 99 / 100]};
+}
+
+
+int main() {
+    {
+        // submit with arguments, the result comes as a future
+        ThreadPool pool(2, Pinning::cores);
+        auto sum = pool.submit([](int a, int b) { return a + b; }, 2, 3);
+        auto fails = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+        std::cout << "2 + 3 = " << sum.get() << std::endl;
+        try {
+            fails.get();
+        } catch (const std::exception& e) {
+            std::cout << "exception from the pool: " << e.what() << std::endl;
+        }
+        // the destructor finishes these before joining
+        for (int i=0; i<4; ++i) {
+            pool.post([i]() { spin_work(i); });
+        }
+    }
+
+    std::size_t max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads=1; threads<max_threads; threads*=2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << "million tasks per second, " << root_tasks << " tasks creating "
+        << child_tasks << " tasks each (" << std::thread::hardware_concurrency()
+        << " cores)" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "mutex queue"
+        << std::setw(16) << "work stealing" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (std::size_t threads : thread_counts) {
+        std::cout << std::setw(8) << threads
+            << std::setw(14) << throughput<QueuePool>(threads)
+            << std::setw(16) << throughput<ThreadPool>(threads) << std::endl;
+    }
+
+    auto [queue_median, queue_p99] = latency<QueuePool>(max_threads);
+    auto [steal_median, steal_p99] = latency<ThreadPool>(max_threads);
+    std::cout << "latency of a single task in us (median / 99%)" << std::endl;
+    std::cout << "    mutex queue:   " << queue_median << " / " << queue_p99 << std::endl;
+    std::cout << "    work stealing: " << steal_median << " / " << steal_p99 << std::endl;
+}
+
+#endif // of #if __cplusplus < 201709L #else ...
@@ -0,0 +1,561 @@
+ /* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    The header of "template_specification_with_userdefined_traits.cpp"
+    motivates copy(TypeA, TypeB) as sending data to a remote process
+    and copy(TypeB, TypeA) as receiving it; there both are plain
+    assignments. Here the same trait-dispatched overloads start real
+    transfers through a CopyEngine:
+        - LocalBuffer<T> (is_A) is an array in this process
+        - RemoteBuffer<T> (is_B) is a range of the memory of a second
+          process, the stand-in for an MPI rank or a GPU
+        - copy() returns a Transfer, a completion handle with ready()
+          and wait(), instead of blocking; its destructor waits, so
+          copy(a, b); without keeping the handle is still synchronous
+    The engine forks the remote process and talks to it through a
+    shared memory mapping (mmap MAP_SHARED before fork; independent
+    programs would use shm_open with a name instead). The mapping holds
+    a ring of slots, each with a payload area and a process-shared POSIX
+    semaphore that the remote process posts when the slot is done.
+    std::atomic::wait cannot be used: it sleeps on a private futex,
+    which a different process cannot wake.
+
+    Transfers larger than a slot are split into chunks, and up to
+    'slots' chunks are in flight at once; copy() only blocks while all
+    slots are taken, i.e. for the part of a transfer that does not
+    fit. The remote process handles them in order; the local side
+    collects the completions in the same order whenever it needs a
+    free slot or a handle is tested.
+    The engine is used from one thread only and has to be created
+    before other threads are started (fork copies only the calling
+    thread).
+
+    The main function uses two local buffers (double buffering): while
+    block i is computed, block i+1 is received and the result of block
+    i-1 is sent, so computation overlaps with communication. It compares
+    this with a loop that receives, computes and sends one block after
+    the other.
+*/
+
+#include <type_traits>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <utility>
+#include <stdexcept>
+#include <system_error>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <semaphore.h>
+#include <unistd.h>
+
+
+// ############ Definition of helper keywords ##############
+// define 'Require' keyword
+template <typename T, typename... Args>
+using Require = typename std::common_type<T, Args...>::type;
+
+// common type
+template <typename T>
+using Type
+    = std::enable_if_t<std::remove_reference<T>::type::is_Type::value,
+        bool>;
+
+// type A: local data
+template <typename T>
+using TypeA
+    = std::enable_if_t<std::remove_reference<T>::type::is_A::value,
+        bool>;
+
+// type B: remote data
+template <typename T>
+using TypeB
+    = std::enable_if_t<std::remove_reference<T>::type::is_B::value,
+        bool>;
+
+// ############ Definition of the copy engine ##############
+inline void check(bool ok, const char* what) {
+    if (!ok) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+}
+
+// sem_wait returns early when a signal arrives
+inline void wait_for(sem_t* s) {
+    while (sem_wait(s) != 0) {
+        check(errno == EINTR, "sem_wait");
+    }
+}
+
+class CopyEngine;
+
+// Completion handle of one copy; move only. Waits for the transfer in
+// its destructor, so the buffers of a transfer are never released
+// while it is in flight.
+class Transfer {
+private:
+    CopyEngine* engine = nullptr;
+    // chunks still in flight, shared with the engine
+    std::shared_ptr<std::size_t> pending;
+
+    friend class CopyEngine;
+
+    Transfer(CopyEngine* e, std::shared_ptr<std::size_t> p)
+        : engine(e), pending(std::move(p)) {
+    }
+
+public:
+    Transfer() = default;
+
+    Transfer(Transfer&& other) noexcept
+        : engine(std::exchange(other.engine, nullptr)),
+          pending(std::move(other.pending)) {
+    }
+
+    Transfer& operator=(Transfer&& other) {
+        if (this != &other) {
+            wait();
+            engine = std::exchange(other.engine, nullptr);
+            pending = std::move(other.pending);
+        }
+        return *this;
+    }
+
+    ~Transfer() {
+        wait();
+    }
+
+    Transfer(const Transfer&) = delete;
+    Transfer& operator=(const Transfer&) = delete;
+
+    // does not block
+    bool ready();
+
+    void wait();
+};
+
+class CopyEngine {
+private:
+    enum class Op : std::uint32_t { put, get, stop };
+
+    struct Slot {
+        sem_t done;
+        Op op;
+        std::size_t offset;
+        std::size_t bytes;
+    };
+
+    static constexpr std::size_t max_slots = 64;
+
+    // at the start of the shared mapping, followed by the payloads
+    struct Channel {
+        // number of submitted slots in 'ring'
+        sem_t requests;
+        std::uint32_t ring[max_slots];
+        Slot slots[max_slots];
+    };
+
+    // a submitted chunk, until its completion has been collected
+    struct InFlight {
+        std::uint32_t slot;
+        std::shared_ptr<std::size_t> pending;
+        // destination of a get, nullptr for a put
+        void* to;
+        std::size_t bytes;
+    };
+
+    std::size_t slots;
+    std::size_t slot_bytes;
+    std::size_t remote_bytes;
+    std::size_t mapping_bytes;
+    Channel* channel = nullptr;
+    std::byte* payloads = nullptr;
+    pid_t remote = -1;
+
+    // local side only
+    std::vector<std::uint32_t> free_slots;
+    std::deque<InFlight> in_flight;
+    std::size_t ring_tail = 0;
+
+    std::byte* payload(std::uint32_t slot) {
+        return payloads + slot * slot_bytes;
+    }
+
+    // the main loop of the remote process; 'memory' is its own copy
+    // of the private mapping
+    [[noreturn]] void serve(std::byte* memory) {
+        std::size_t ring_head = 0;
+        for (;;) {
+            wait_for(&channel->requests);
+            const std::uint32_t index = channel->ring[ring_head];
+            ring_head = (ring_head + 1) % slots;
+            Slot& s = channel->slots[index];
+            if (s.op == Op::put) {
+                std::memcpy(memory + s.offset, payload(index), s.bytes);
+            } else if (s.op == Op::get) {
+                std::memcpy(payload(index), memory + s.offset, s.bytes);
+            }
+            sem_post(&s.done);
+            if (s.op == Op::stop) {
+                _exit(0);
+            }
+        }
+    }
+
+    std::uint32_t acquire_slot() {
+        while (free_slots.empty()) {
+            progress(true);
+        }
+        const std::uint32_t slot = free_slots.back();
+        free_slots.pop_back();
+        return slot;
+    }
+
+    void submit(std::uint32_t slot) {
+        channel->ring[ring_tail] = slot;
+        ring_tail = (ring_tail + 1) % slots;
+        // sem_post publishes the slot (memory synchronization)
+        sem_post(&channel->requests);
+    }
+
+    Transfer start(Op op, const void* from, void* to, std::size_t bytes, std::size_t remote_offset) {
+        if (remote_offset > remote_bytes || bytes > remote_bytes - remote_offset) {
+            throw std::out_of_range("copy engine: range exceeds the remote memory");
+        }
+        auto pending = std::make_shared<std::size_t>((bytes + slot_bytes - 1) / slot_bytes);
+        for (std::size_t done=0; done<bytes; done+=slot_bytes) {
+            const std::size_t chunk = std::min(slot_bytes, bytes - done);
+            const std::uint32_t slot = acquire_slot();
+            Slot& s = channel->slots[slot];
+            s.op = op;
+            s.offset = remote_offset + done;
+            s.bytes = chunk;
+            if (op == Op::put) {
+                std::memcpy(payload(slot), static_cast<const std::byte*>(from) + done, chunk);
+            }
+            in_flight.push_back({slot, pending,
+                op == Op::get ? static_cast<std::byte*>(to) + done : nullptr, chunk});
+            submit(slot);
+        }
+        return Transfer(this, std::move(pending));
+    }
+
+public:
+    // forks the remote process with remote_bytes of memory
+    explicit CopyEngine(std::size_t remote_bytes, std::size_t slots = 8,
+        std::size_t slot_bytes = 1 << 16)
+        : slots(slots), slot_bytes(slot_bytes), remote_bytes(remote_bytes) {
+        if (slots == 0 || slots > max_slots || slot_bytes == 0) {
+            throw std::invalid_argument("copy engine: 1 to 64 slots of at least one byte");
+        }
+        const std::size_t header = (sizeof(Channel) + 63) / 64 * 64;
+        mapping_bytes = header + slots * slot_bytes;
+        void* shared = mmap(nullptr, mapping_bytes, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        check(shared != MAP_FAILED, "mmap");
+        channel = new (shared) Channel;
+        payloads = static_cast<std::byte*>(shared) + header;
+        // the memory of the remote process: mapped here, but private,
+        // so after fork only the child's copy is used
+        void* memory = mmap(nullptr, remote_bytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            const int error = errno;
+            munmap(shared, mapping_bytes);
+            throw std::system_error(error, std::generic_category(), "mmap");
+        }
+        // the request semaphore comes last, so on failure only the
+        // first 'ready' slot semaphores have to be destroyed
+        std::size_t ready = 0;
+        try {
+            for (; ready<slots; ++ready) {
+                check(sem_init(&channel->slots[ready].done, 1, 0) == 0, "sem_init");
+                free_slots.push_back(static_cast<std::uint32_t>(slots - 1 - ready));
+            }
+            check(sem_init(&channel->requests, 1, 0) == 0, "sem_init");
+        } catch (...) {
+            for (std::size_t i=0; i<ready; ++i) {
+                sem_destroy(&channel->slots[i].done);
+            }
+            munmap(memory, remote_bytes);
+            munmap(shared, mapping_bytes);
+            throw;
+        }
+        // the child would print what is still buffered a second time
+        std::cout.flush();
+        remote = fork();
+        if (remote == 0) {
+            serve(static_cast<std::byte*>(memory));
+        }
+        const int error = errno;
+        munmap(memory, remote_bytes);
+        if (remote < 0) {
+            munmap(shared, mapping_bytes);
+            throw std::system_error(error, std::generic_category(), "fork");
+        }
+    }
+
+    // finishes all transfers and stops the remote process
+    ~CopyEngine() {
+        while (!in_flight.empty()) {
+            progress(true);
+        }
+        const std::uint32_t slot = acquire_slot();
+        channel->slots[slot].op = Op::stop;
+        submit(slot);
+        wait_for(&channel->slots[slot].done);
+        waitpid(remote, nullptr, 0);
+        sem_destroy(&channel->requests);
+        for (std::size_t i=0; i<slots; ++i) {
+            sem_destroy(&channel->slots[i].done);
+        }
+        munmap(channel, mapping_bytes);
+    }
+
+    CopyEngine(const CopyEngine&) = delete;
+    CopyEngine& operator=(const CopyEngine&) = delete;
+
+    std::size_t size() const {
+        return remote_bytes;
+    }
+
+    // send bytes to the remote memory at remote_offset
+    Transfer put(const void* from, std::size_t bytes, std::size_t remote_offset) {
+        return start(Op::put, from, nullptr, bytes, remote_offset);
+    }
+
+    // receive bytes from the remote memory at remote_offset
+    Transfer get(void* to, std::size_t bytes, std::size_t remote_offset) {
+        return start(Op::get, nullptr, to, bytes, remote_offset);
+    }
+
+    // Collects the oldest completion; returns false if nothing is in
+    // flight or (blocking == false) the oldest chunk is not done yet
+    bool progress(bool blocking) {
+        if (in_flight.empty()) {
+            return false;
+        }
+        InFlight& f = in_flight.front();
+        sem_t* done = &channel->slots[f.slot].done;
+        if (blocking) {
+            wait_for(done);
+        } else if (sem_trywait(done) != 0) {
+            check(errno == EAGAIN || errno == EINTR, "sem_trywait");
+            return false;
+        }
+        if (f.to != nullptr) {
+            std::memcpy(f.to, payload(f.slot), f.bytes);
+        }
+        --*f.pending;
+        free_slots.push_back(f.slot);
+        in_flight.pop_front();
+        return true;
+    }
+};
+
+inline bool Transfer::ready() {
+    if (!pending) {
+        return true;
+    }
+    while (*pending > 0 && engine->progress(false)) {
+    }
+    return *pending == 0;
+}
+
+inline void Transfer::wait() {
+    if (!pending) {
+        return;
+    }
+    while (*pending > 0) {
+        engine->progress(true);
+    }
+    pending.reset();
+}
+
+// ############ Definition of example classes ##############
+// local data
+template <typename T>
+class LocalBuffer {
+public:
+    std::vector<T> data;
+
+    // def type attributes
+    using is_Type = std::true_type;
+    using is_A = std::true_type;
+
+    explicit LocalBuffer(std::size_t n) : data(n) {
+    }
+};
+
+// data in the memory of the remote process: n elements of T at
+// element offset 'offset'
+template <typename T>
+class RemoteBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+        "only trivially copyable types can be sent");
+
+public:
+    CopyEngine* engine;
+    std::size_t offset;
+    std::size_t n;
+
+    // def type attributes
+    using is_Type = std::true_type;
+    using is_B = std::true_type;
+
+    RemoteBuffer(CopyEngine& e, std::size_t offset, std::size_t n)
+        : engine(&e), offset(offset), n(n) {
+    }
+
+    // n elements starting at element first of this buffer
+    RemoteBuffer part(std::size_t first, std::size_t count) const {
+        return RemoteBuffer(*engine, offset + first, count);
+    }
+};
+
+// ############ Definition of example functions ##############
+// send: copy from A (local) to B (remote)
+template <class TypeX,
+    class TypeY,
+    Require< TypeA<TypeX>,
+            TypeB<TypeY> > = true>
+Transfer copy(TypeX& x, TypeY& y) {
+    using T = typename decltype(x.data)::value_type;
+    if (x.data.size() != y.n) {
+        throw std::length_error("copy: sizes differ");
+    }
+    return y.engine->put(x.data.data(), y.n * sizeof(T), y.offset * sizeof(T));
+}
+
+// receive: copy from B (remote) to A (local)
+template <class TypeX,
+    class TypeY,
+    Require< TypeB<TypeX>,
+            TypeA<TypeY> > = true>
+Transfer copy(TypeX& x, TypeY& y) {
+    using T = typename decltype(y.data)::value_type;
+    if (y.data.size() != x.n) {
+        throw std::length_error("copy: sizes differ");
+    }
+    return x.engine->get(y.data.data(), x.n * sizeof(T), x.offset * sizeof(T));
+}
+
+// the local computation on one block
+void compute(LocalBuffer<double>& b) {
+    for (double& x : b.data) {
+        x = std::sqrt(x) + std::sin(x);
+    }
+}
+
+template <typename F>
+double milliseconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> dt = std::chrono::steady_clock::now() - start;
+    return dt.count();
+}
+
+
+// ############ Add main function ##############
+int main() {
+    constexpr std::size_t block = 1 << 15;
+    constexpr std::size_t blocks = 64;
+    constexpr std::size_t n = block * blocks;
+
+    // remote memory: input (n doubles) followed by output (n doubles)
+    CopyEngine engine(2 * n * sizeof(double));
+    RemoteBuffer<double> input(engine, 0, n);
+    RemoteBuffer<double> output(engine, n, n);
+
+    // fill the remote input; several chunks are in flight at once
+    LocalBuffer<double> all(n);
+    for (std::size_t i=0; i<n; ++i) {
+        all.data[i] = static_cast<double>(i);
+    }
+    Transfer t = copy(all, input);
+    std::cout << "sending " << n * sizeof(double) / (1 << 20) << " MiB, ready right after copy(): "
+        << std::boolalpha << t.ready() << std::endl;
+    t.wait();
+    std::cout << "ready after wait(): " << t.ready() << std::endl;
+
+    // one block after the other: receive, compute, send
+    const double serial = milliseconds([&]() {
+        LocalBuffer<double> buffer(block);
+        for (std::size_t i=0; i<blocks; ++i) {
+            RemoteBuffer<double> in = input.part(i * block, block);
+            RemoteBuffer<double> out = output.part(i * block, block);
+            copy(in, buffer).wait();
+            compute(buffer);
+            copy(buffer, out).wait();
+        }
+    });
+
+    // double buffering: block i+1 is received and block i-1 sent
+    // while block i is computed
+    const double overlapped = milliseconds([&]() {
+        LocalBuffer<double> buffer[2] = {LocalBuffer<double>(block), LocalBuffer<double>(block)};
+        Transfer received[2];
+        Transfer sent[2];
+        RemoteBuffer<double> first = input.part(0, block);
+        received[0] = copy(first, buffer[0]);
+        for (std::size_t i=0; i<blocks; ++i) {
+            const std::size_t cur = i % 2;
+            const std::size_t next = 1 - cur;
+            if (i + 1 < blocks) {
+                // the other buffer may still be on its way out
+                sent[next].wait();
+                RemoteBuffer<double> in = input.part((i + 1) * block, block);
+                received[next] = copy(in, buffer[next]);
+            }
+            received[cur].wait();
+            compute(buffer[cur]);
+            RemoteBuffer<double> out = output.part(i * block, block);
+            sent[cur] = copy(buffer[cur], out);
+        }
+        // the destructors of 'sent' wait for the last blocks
+    });
+
+    // check the result in the remote memory
+    LocalBuffer<double> result(n);
+    copy(output, result);
+    bool ok = true;
+    for (std::size_t i=0; i<n; ++i) {
+        const double x = static_cast<double>(i);
+        ok = ok && result.data[i] == std::sqrt(x) + std::sin(x);
+    }
+    std::cout << blocks << " blocks of " << block * sizeof(double) / 1024 << " KiB, "
+        << std::fixed << std::setprecision(2)
+        << "one after the other: " << serial << " ms, double buffered: "
+        << overlapped << " ms, result " << (ok ? "correct" : "WRONG") << std::endl;
+}
@@ -0,0 +1,436 @@
+ /* 
+    Copyright (c) 2026 Lennart Bosch
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* 
+    Created by: Lennart Hendrik Bosch
+    Creation date: 17 Oct 2026
+
+    A continuation of "template_template_specification_with_userdefined_traits.cpp"
+    for many objects. Millions of TypeAclass<T> objects, each handled
+    through set/copy/print, cost one call per object and (if they are
+    allocated one by one) one cache miss per object. TypeCollection
+    stores the same data as a structure of arrays: every field of the
+    class gets its own contiguous array (the example classes have a
+    single field, number, so there is one array). The trait tags
+    is_Type, is_A and is_B of the element class are kept at the level
+    of the collection, and is_Bulk marks it as a collection.
+
+    The bulk overloads of set, copy and print are selected with the
+    same 'Require' keyword as the single-object ones, e.g.
+    copy(TypeCollection<TypeAclass, T>&, TypeCollection<TypeBclass, T>&)
+    is "copy A to B" for all elements. Their loops run over plain
+    arrays, which the compiler vectorizes (-O2 since gcc 12, or -O3;
+    -fopt-info-vec lists the vectorized loops).
+
+    The benchmark in main shows where the gain comes from: against
+    objects allocated one by one the collection is several times
+    faster. Against a std::vector of objects it is not, because with
+    a single field that vector already has the same layout. There,
+    set followed by copy is even slower, as it makes two passes over
+    memory, and only the fused set_and_copy (one pass) is a bit
+    faster. The structure of arrays pays off once the class has more
+    fields than a loop touches.
+
+    The file is organized as the other files of this folder: helper
+    keyword definition, example classes definition, example function
+    definition, main function.
+*/
+
+#include <type_traits>
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
+
+// ############ Definition of helper keywords ##############
+// define 'Require' keyword
+template <typename T, typename... Args>
+using Require = typename std::common_type<T, Args...>::type;
+
+// common type
+template <typename T>
+using Type
+    = std::enable_if_t<std::remove_reference<T>::type::is_Type::value,
+        bool>;
+
+// type A
+template <typename T>
+using TypeA
+    = std::enable_if_t<std::remove_reference<T>::type::is_A::value,
+        bool>;
+
+// type B
+template <typename T>
+using TypeB
+    = std::enable_if_t<std::remove_reference<T>::type::is_B::value,
+        bool>;
+
+// collection of many objects
+template <typename T>
+using Bulk
+    = std::enable_if_t<std::remove_reference<T>::type::is_Bulk::value,
+        bool>;
+
+// the following types take over a trait of a class if it has it,
+// and nothing otherwise (a TypeBclass has no is_A at all)
+template <class X, typename = void>
+struct forward_is_Type {
+};
+
+template <class X>
+struct forward_is_Type<X, std::void_t<typename X::is_Type>> {
+    using is_Type = typename X::is_Type;
+};
+
+template <class X, typename = void>
+struct forward_is_A {
+};
+
+template <class X>
+struct forward_is_A<X, std::void_t<typename X::is_A>> {
+    using is_A = typename X::is_A;
+};
+
+template <class X, typename = void>
+struct forward_is_B {
+};
+
+template <class X>
+struct forward_is_B<X, std::void_t<typename X::is_B>> {
+    using is_B = typename X::is_B;
+};
+
+// ############ Definition of example classes ##############
+// as in template_template_specification_with_userdefined_traits.cpp
+template <typename T>
+class TypeAclass {
+public:
+    T number;
+
+    using is_Type = std::true_type;
+    using is_A = std::true_type;
+
+    TypeAclass(T num) : number(num) {
+    }
+};
+
+template <typename T>
+class TypeBclass {
+public:
+    T number;
+
+    using is_Type = std::true_type;
+    using is_B = std::true_type;
+
+    TypeBclass(T num) : number(num) {
+    }
+};
+
+// Structure of arrays of TypeX<T>; the trait tags of TypeX<T> are
+// inherited, so TypeCollection<TypeAclass, T> is an A and
+// TypeCollection<TypeBclass, T> is a B
+template <template<typename> class TypeX, typename T>
+class TypeCollection
+    : public forward_is_Type<TypeX<T>>,
+      public forward_is_A<TypeX<T>>,
+      public forward_is_B<TypeX<T>> {
+private:
+    // one array per field of TypeX
+    std::vector<T> numbers;
+
+public:
+    using is_Bulk = std::true_type;
+    using element_type = TypeX<T>;
+
+    TypeCollection(std::size_t n, T num) : numbers(n, num) {
+    }
+
+    std::size_t size() const {
+        return numbers.size();
+    }
+
+    // the fields of element i
+    T& number(std::size_t i) {
+        return numbers[i];
+    }
+
+    const T& number(std::size_t i) const {
+        return numbers[i];
+    }
+
+    // the whole array of a field, for the bulk functions
+    T* number_data() {
+        return numbers.data();
+    }
+
+    const T* number_data() const {
+        return numbers.data();
+    }
+
+    // element i as an object, and back
+    TypeX<T> get(std::size_t i) const {
+        return TypeX<T>(numbers[i]);
+    }
+
+    void put(std::size_t i, const TypeX<T>& x) {
+        numbers[i] = x.number;
+    }
+
+    void push_back(const TypeX<T>& x) {
+        numbers.push_back(x.number);
+    }
+};
+
+// ############ Definition of example functions ##############
+// single objects, as in template_template_specification_with_userdefined_traits.cpp
+// but without the output, as they are called millions of times below
+template <template<typename> class TypeX,
+    typename T,
+    Require< TypeA<TypeX<T>> > = true>
+void set(TypeX<T>& X) {
+    X.number = 42;
+}
+
+template <template<typename> class TypeX,
+    typename T,
+    Require< TypeB<TypeX<T>> > = true>
+void set(TypeX<T>& X) {
+    X.number = 666;
+}
+
+template <template<typename> class TypeX,
+    typename T,
+    Require< Type<TypeX<T>> > = true>
+void print(TypeX<T>& x) {
+    std::cout << "number in arg: " << x.number << std::endl;
+}
+
+template <template<typename> class TypeX,
+    template<typename> class TypeY,
+    typename T,
+    Require< TypeA<TypeX<T>>,
+            TypeB<TypeY<T>> > = true>
+void copy(TypeX<T>& x, TypeY<T>& y) {
+    y.number = x.number;
+}
+
+template <template<typename> class TypeX,
+    template<typename> class TypeY,
+    typename T,
+    Require< TypeB<TypeX<T>>,
+            TypeA<TypeY<T>> > = true>
+void copy(TypeX<T>& x, TypeY<T>& y) {
+    y.number = x.number;
+}
+
+// Bulk versions: the same 'Require' dispatch on the traits of the
+// collection, plus is_Bulk; a TypeCollection does not match the
+// TypeX<T> parameters above, so there is no ambiguity.
+// The loops run over the raw arrays; __restrict tells the compiler
+// that the arrays of x and y do not overlap, so it can vectorize
+// without a runtime check.
+template <template<typename> class TypeX,
+    typename T,
+    Require< TypeA<TypeCollection<TypeX, T>>,
+            Bulk<TypeCollection<TypeX, T>> > = true>
+void set(TypeCollection<TypeX, T>& X) {
+    T* __restrict n = X.number_data();
+    for (std::size_t i=0; i<X.size(); ++i) {
+        n[i] = 42;
+    }
+}
+
+template <template<typename> class TypeX,
+    typename T,
+    Require< TypeB<TypeCollection<TypeX, T>>,
+            Bulk<TypeCollection<TypeX, T>> > = true>
+void set(TypeCollection<TypeX, T>& X) {
+    T* __restrict n = X.number_data();
+    for (std::size_t i=0; i<X.size(); ++i) {
+        n[i] = 666;
+    }
+}
+
+// prints the size and the first elements
+template <template<typename> class TypeX,
+    typename T,
+    Require< Type<TypeCollection<TypeX, T>>,
+            Bulk<TypeCollection<TypeX, T>> > = true>
+void print(TypeCollection<TypeX, T>& x) {
+    std::cout << x.size() << " numbers in arg:";
+    for (std::size_t i=0; i<x.size() && i<4; ++i) {
+        std::cout << " " << x.number(i);
+    }
+    std::cout << (x.size() > 4 ? " ..." : "") << std::endl;
+}
+
+template <class TypeX, class TypeY>
+void copy_numbers(const TypeX& x, TypeY& y) {
+    if (x.size() != y.size()) {
+        throw std::length_error("copy: collections differ in size");
+    }
+    const auto* __restrict from = x.number_data();
+    auto* __restrict to = y.number_data();
+    for (std::size_t i=0; i<x.size(); ++i) {
+        to[i] = from[i];
+    }
+}
+
+template <template<typename> class TypeX,
+    template<typename> class TypeY,
+    typename T,
+    Require< TypeA<TypeCollection<TypeX, T>>,
+            TypeB<TypeCollection<TypeY, T>>,
+            Bulk<TypeCollection<TypeX, T>> > = true>
+void copy(TypeCollection<TypeX, T>& x, TypeCollection<TypeY, T>& y) {
+    copy_numbers(x, y);
+}
+
+template <template<typename> class TypeX,
+    template<typename> class TypeY,
+    typename T,
+    Require< TypeB<TypeCollection<TypeX, T>>,
+            TypeA<TypeCollection<TypeY, T>>,
+            Bulk<TypeCollection<TypeX, T>> > = true>
+void copy(TypeCollection<TypeX, T>& x, TypeCollection<TypeY, T>& y) {
+    copy_numbers(x, y);
+}
+
+// set(x) followed by copy(x, y) in a single pass: the separate bulk
+// calls stream over x twice, which is slower than the one by one
+// loop over a vector as soon as the arrays do not fit into the cache
+template <template<typename> class TypeX,
+    template<typename> class TypeY,
+    typename T,
+    Require< TypeA<TypeCollection<TypeX, T>>,
+            TypeB<TypeCollection<TypeY, T>>,
+            Bulk<TypeCollection<TypeX, T>> > = true>
+void set_and_copy(TypeCollection<TypeX, T>& x, TypeCollection<TypeY, T>& y) {
+    if (x.size() != y.size()) {
+        throw std::length_error("set_and_copy: collections differ in size");
+    }
+    T* __restrict from = x.number_data();
+    T* __restrict to = y.number_data();
+    for (std::size_t i=0; i<x.size(); ++i) {
+        from[i] = 42;
+        to[i] = from[i];
+    }
+}
+
+template <template<typename> class TypeX,
+    template<typename> class TypeY,
+    typename T,
+    Require< TypeB<TypeCollection<TypeX, T>>,
+            TypeA<TypeCollection<TypeY, T>>,
+            Bulk<TypeCollection<TypeX, T>> > = true>
+void set_and_copy(TypeCollection<TypeX, T>& x, TypeCollection<TypeY, T>& y) {
+    if (x.size() != y.size()) {
+        throw std::length_error("set_and_copy: collections differ in size");
+    }
+    T* __restrict from = x.number_data();
+    T* __restrict to = y.number_data();
+    for (std::size_t i=0; i<x.size(); ++i) {
+        from[i] = 666;
+        to[i] = from[i];
+    }
+}
+
+// runs f a few times and returns the best time in milliseconds
+template <typename F>
+double milliseconds(F f) {
+    double best = 1e30;
+    for (int run=0; run<5; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> dt = std::chrono::steady_clock::now() - start;
+        best = dt.count() < best ? dt.count() : best;
+    }
+    return best;
+}
+
+
+// ############ Add main function ##############
+int main() {
+
+    // the same calls as for single objects
+    TypeCollection<TypeAclass, int> a(8, 3);
+    TypeCollection<TypeBclass, int> b(8, 5);
+    print(a);
+    print(b);
+    set(a);
+    copy(a, b);
+    print(a);
+    print(b);
+
+    std::cout << "Set numbers in B to 666" << std::endl;
+    set(b);
+    copy(b, a);
+    print(a);
+
+    // single elements still work as objects
+    TypeAclass<int> x = a.get(2);
+    print(x);
+
+    // millions of objects: one at a time (allocated one by one, as
+    // in the original example, or in a vector) against the collections;
+    // with a single field a vector of objects has the same layout as
+    // the collection, with more fields every loop over one field of
+    // the objects would also load all the others
+    constexpr std::size_t n = 1 << 22;
+    std::vector<std::unique_ptr<TypeAclass<double>>> heap_a;
+    std::vector<std::unique_ptr<TypeBclass<double>>> heap_b;
+    std::vector<TypeAclass<double>> vector_a;
+    std::vector<TypeBclass<double>> vector_b;
+    for (std::size_t i=0; i<n; ++i) {
+        heap_a.push_back(std::make_unique<TypeAclass<double>>(1.0));
+        heap_b.push_back(std::make_unique<TypeBclass<double>>(2.0));
+        vector_a.emplace_back(1.0);
+        vector_b.emplace_back(2.0);
+    }
+    TypeCollection<TypeAclass, double> many_a(n, 1.0);
+    TypeCollection<TypeBclass, double> many_b(n, 2.0);
+
+    std::cout << std::endl << "set and copy A to B for " << n << " objects:" << std::endl;
+    std::cout << "  one by one, heap:   " << milliseconds([&]() {
+        for (std::size_t i=0; i<n; ++i) {
+            set(*heap_a[i]);
+            copy(*heap_a[i], *heap_b[i]);
+        }
+    }) << " ms" << std::endl;
+    std::cout << "  one by one, vector: " << milliseconds([&]() {
+        for (std::size_t i=0; i<n; ++i) {
+            set(vector_a[i]);
+            copy(vector_a[i], vector_b[i]);
+        }
+    }) << " ms" << std::endl;
+    std::cout << "  collection:         " << milliseconds([&]() {
+        set(many_a);
+        copy(many_a, many_b);
+    }) << " ms" << std::endl;
+    std::cout << "  collection, fused:  " << milliseconds([&]() {
+        set_and_copy(many_a, many_b);
+    }) << " ms" << std::endl;
+    print(many_b);
+}